@@ -1,10 +1,14 @@
 #include <algorithm>
+#include <array>
 #include <concepts>
 #include <cstddef>
 #include <iostream>
 #include <limits>
+#include <type_traits>
 #include <utility>
 
+#include "instrumentation/ScopeCounters.h"
+
 /*
  * Generates the coordinates needed to traverse an 2D array diagonally.
  * Width and height of the array do not need to be equal.
@@ -71,6 +75,7 @@ template<typename Consumer>
 constexpr void iterate_diagonal(
         std::size_t width, std::size_t height, Consumer consumer
 ) noexcept(noexcept(std::declval<Consumer>()(std::declval<Point>()))) {
+    CPPPLAYGROUND_SCOPE_COUNTERS("iterate_diagonal");
     iter_diag_upper_halve_top_right_to_bottom_left_left_to_right(
             width, height, consumer);
 
@@ -85,6 +90,87 @@ constexpr void iterate_diagonal(
             height, width, translate);
 }
 
+/*
+ * For small, fixed sized arrays the bounds arithmetic of the nested loops above
+ * costs more than the work done per cell. Thus for these sizes, the traversal
+ * order is computed once at compile time and stored as row major offsets (i.e.
+ * `row * width + col`) and as points.
+ * The `d`-th diagonal contains all points with `row + col == d`, each visited
+ * with an increasing row, which yields the same order as `iterate_diagonal`.
+ */
+
+template<std::size_t Width, std::size_t Height>
+    requires (Width > 0 && Height > 0)
+[[nodiscard]] consteval std::array<std::size_t, Width * Height>
+make_diagonal_offsets() noexcept {
+    std::array<std::size_t, Width * Height> offsets{};
+    std::size_t index{0};
+    for (std::size_t diagonal = 0; diagonal < Width + Height - 1; ++diagonal) {
+        const std::size_t first_row{diagonal < Width ? 0 : diagonal - Width + 1};
+        const std::size_t last_row{std::min(diagonal, Height - 1)};
+        for (std::size_t row = first_row; row <= last_row; ++row) {
+            offsets[index++] = row * Width + (diagonal - row);
+        }
+    }
+
+    return offsets;
+}
+
+template<std::size_t Width, std::size_t Height>
+inline constexpr std::array<std::size_t, Width * Height> diagonal_offsets{
+        make_diagonal_offsets<Width, Height>()};
+
+template<std::size_t Width, std::size_t Height>
+inline constexpr std::array<Point, Width * Height> diagonal_order{
+    []<std::size_t... I>(std::index_sequence<I...>) {
+        constexpr auto &offsets{diagonal_offsets<Width, Height>};
+        return std::array<Point, Width * Height>{
+            Point{offsets[I] / Width, offsets[I] % Width}...};
+    }(std::make_index_sequence<Width * Height>{})
+};
+
+/*
+ * Same as `iterate_diagonal`, but for an array with a size known at compile
+ * time. The loop is fully unrolled over the precomputed table, so no bounds
+ * arithmetic is left at runtime.
+ */
+template<std::size_t Width, std::size_t Height, typename Consumer>
+    requires std::invocable<Consumer, Point>
+            && std::same_as<std::invoke_result_t<Consumer, Point>, void>
+inline constexpr void iterate_diagonal(Consumer consumer)
+        noexcept(noexcept(std::declval<Consumer>()(std::declval<Point>()))) {
+    CPPPLAYGROUND_SCOPE_COUNTERS("iterate_diagonal<Width, Height>");
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (consumer(diagonal_order<Width, Height>[I]), ...);
+    }(std::make_index_sequence<Width * Height>{});
+}
+
+template<std::size_t Width, std::size_t Height>
+[[nodiscard]] consteval bool diagonal_order_matches_iterate_diagonal() noexcept {
+    std::size_t index{0};
+    bool matches{true};
+    auto compare {
+        [&index, &matches](Point p) {
+            const Point expected{diagonal_order<Width, Height>[index++]};
+            matches = matches && expected.row == p.row && expected.col == p.col;
+        }
+    };
+
+    iterate_diagonal(Width, Height, compare);
+    return matches && index == Width * Height;
+}
+
+static_assert(diagonal_order_matches_iterate_diagonal<1, 1>());
+static_assert(diagonal_order_matches_iterate_diagonal<1, 5>());
+static_assert(diagonal_order_matches_iterate_diagonal<5, 1>());
+static_assert(diagonal_order_matches_iterate_diagonal<3, 4>());
+static_assert(diagonal_order_matches_iterate_diagonal<4, 3>());
+static_assert(diagonal_order_matches_iterate_diagonal<8, 8>());
+static_assert(diagonal_order_matches_iterate_diagonal<16, 16>());
+
+static_assert(diagonal_offsets<3, 4> == std::array<std::size_t, 12>{
+        0, 1, 3, 2, 4, 6, 5, 7, 9, 8, 10, 11});
+
 void print_traversed_coordinates(std::size_t width, std::size_t height) {
     auto printPoint {[](Point p) {std::cout << p << '\n';}};
     iterate_diagonal(width, height, printPoint);
@@ -95,4 +181,7 @@ int main(const int argc, char const *const *const argv) {
     std::size_t height {3};
 
     print_traversed_coordinates(width, height);
+
+    std::cout << '\n';
+    iterate_diagonal<4, 3>([](Point p) { std::cout << p << '\n'; });
 }
@@ -49,7 +49,7 @@ public:
     }
 
 private:
-    std::unique_ptr<T> ptr;
+    std::unique_ptr<T[]> ptr;
     std::size_t size;
 };
 
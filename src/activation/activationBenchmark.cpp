@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "activations.h"
+#include "quantization.h"
+
+/*
+ * Compares the explicitly vectorised activation kernels against the plain
+ * loops auto-vectorised by the compiler (reported as "scalar").
+ * Each kernel is run over a buffer that is much larger than the caches, once
+ * with an aligned and once with an unaligned output, and the throughput is
+ * reported in GB/s of input consumed.
+ */
+
+constexpr std::size_t element_count{1 << 24};
+constexpr int repetitions{10};
+
+template<typename Kernel>
+[[nodiscard]] double measure_gigabytes_per_second(std::size_t bytes, Kernel kernel) {
+    kernel();
+    auto start{std::chrono::steady_clock::now()};
+    for (int i = 0; i < repetitions; ++i)
+        kernel();
+
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+    return static_cast<double>(bytes) * repetitions / elapsed.count() / 1e9;
+}
+
+template<activation_type T>
+[[nodiscard]] std::vector<T> random_input(std::size_t size) {
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<int> distribution{-100, 100};
+    std::vector<T> input(size);
+    for (T &x : input)
+        x = static_cast<T>(distribution(generator));
+
+    return input;
+}
+
+template<activation_type T>
+void benchmark_type(std::string_view typeName) {
+    // One extra element so that the output can be offset by one element.
+    const std::vector<T> input{random_input<T>(element_count + 1)};
+    std::vector<T> output(element_count + 1);
+    std::vector<sign_mask_t<T>> masks(element_count + 1);
+
+    for (std::size_t offset : {0, 1}) {
+        std::span<const T> in{std::span(input).subspan(offset, element_count)};
+        std::span<T> out{std::span(output).subspan(offset, element_count)};
+        std::span<sign_mask_t<T>> maskOut{std::span(masks).subspan(offset, element_count)};
+
+        for (Isa isa : {Isa::Scalar, Isa::Sse41, Isa::Avx2, Isa::Avx512}) {
+            if (!is_supported(isa))
+                continue;
+
+            auto report {
+                [&](std::string_view kernel, auto run) {
+                    double throughput{measure_gigabytes_per_second(in.size_bytes(), run)};
+                    std::cout << std::left << std::setw(8) << typeName
+                              << std::setw(14) << kernel
+                              << std::setw(10) << (offset == 0 ? "aligned" : "unaligned")
+                              << std::setw(9) << to_string(isa)
+                              << std::right << std::fixed << std::setprecision(2)
+                              << std::setw(8) << throughput << " GB/s\n";
+                }
+            };
+
+            report("relu", [&] { relu(in, out, isa); });
+            report("relu6", [&] { relu6(in, out, isa); });
+            if constexpr (std::floating_point<T>)
+                report("leaky_relu", [&] { leaky_relu(in, out, T(0.01), isa); });
+            report("sign_mask", [&] { sign_mask(in, maskOut, isa); });
+        }
+    }
+}
+
+/*
+ * Compares the fused ReLU and quantization against doing ReLU, scaling and
+ * quantization in separate passes over memory.
+ */
+void benchmark_relu_quantize() {
+    const std::vector<float> input{random_input<float>(element_count)};
+    std::vector<float> temporary(element_count);
+    std::vector<std::int8_t> output(element_count);
+    constexpr float scale{0.5f};
+
+    auto report {
+        [](std::string_view variant, double throughput) {
+            std::cout << std::left << std::setw(44) << variant
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(8) << throughput << " GB/s\n";
+        }
+    };
+
+    const std::size_t bytes{element_count * sizeof(float)};
+    report("relu_quantize separate passes", measure_gigabytes_per_second(bytes, [&] {
+        relu(std::span(input), std::span(temporary));
+        for (float &x : temporary)
+            x *= scale;
+
+        for (std::size_t i = 0; i < element_count; ++i)
+            output[i] = static_cast<std::int8_t>(std::nearbyint(std::min(temporary[i], 127.0f)));
+    }));
+
+    for (bool nonTemporal : {false, true}) {
+        for (std::size_t threads{1}; threads <= std::thread::hardware_concurrency(); threads *= 2) {
+            ReluQuantizeOptions options{.threads = threads, .nonTemporalStores = nonTemporal};
+            std::string variant{"relu_quantize fused, " + std::to_string(threads) + " thread(s)"
+                                + (nonTemporal ? ", streaming" : "")};
+            report(variant, measure_gigabytes_per_second(bytes, [&] {
+                relu_quantize(std::span(input), std::span(output), scale, options);
+            }));
+        }
+    }
+}
+
+int main() {
+    std::cout << "Best supported instruction set: " << to_string(best_supported_isa()) << "\n\n";
+    benchmark_type<float>("float");
+    benchmark_type<double>("double");
+    benchmark_type<std::int8_t>("int8");
+    benchmark_type<std::int16_t>("int16");
+    benchmark_type<std::int32_t>("int32");
+
+    std::cout << '\n';
+    benchmark_relu_quantize();
+}
@@ -0,0 +1,171 @@
+#ifndef CPPPLAYGROUND_ACTIVATIONKERNELS_H
+#define CPPPLAYGROUND_ACTIVATIONKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "activations.h"
+
+/*
+ * Building blocks for the explicitly vectorised activation kernels.
+ * Each instruction set lives in its own translation unit, which is compiled
+ * with the matching `-m` flags and provides an `Ops<T>` class template with
+ * the few intrinsics needed below.
+ *
+ * Caution: Any inline function instantiated in one of these translation units
+ * may be emitted using e.g. AVX-512 instructions and the linker is free to
+ * pick that copy for the whole program. Thus `Ops` must live in an anonymous
+ * namespace and the code below must not call any shared inline functions
+ * (like `std::max` or `std::bit_cast`), so that every instantiation stays
+ * local to its translation unit.
+ */
+
+extern const ActivationKernelTable sse41_activation_kernels;
+extern const ActivationKernelTable avx2_activation_kernels;
+extern const ActivationKernelTable avx512_activation_kernels;
+
+template<typename Ops, typename T, typename U, typename VectorOp, typename ScalarOp>
+inline void transform_activation(const T *input, U *output, std::size_t size,
+                                 VectorOp vectorOp, ScalarOp scalarOp) noexcept {
+    constexpr std::size_t lanes{Ops::lanes};
+    constexpr std::size_t alignment{lanes * sizeof(U)};
+
+    const std::size_t misalignment{reinterpret_cast<std::uintptr_t>(output) % alignment};
+    const std::size_t unaligned{misalignment == 0 ? 0 : (alignment - misalignment) / sizeof(U)};
+    const std::size_t head{unaligned < size ? unaligned : size};
+
+    std::size_t i{0};
+    for (; i < head; ++i)
+        output[i] = scalarOp(input[i]);
+
+    for (; i + lanes <= size; i += lanes)
+        Ops::store(output + i, vectorOp(Ops::load(input + i)));
+
+    for (; i < size; ++i)
+        output[i] = scalarOp(input[i]);
+}
+
+/*
+ * The scalar fallbacks are written such that they produce the very same
+ * results as the max and min instructions of SSE, AVX2 and AVX-512, including
+ * for NaNs and negative zero. These return their second operand if the
+ * comparison is false.
+ */
+
+template<typename Ops>
+void relu_kernel(const typename Ops::value_type *input, typename Ops::value_type *output,
+                 std::size_t size) noexcept {
+    using T = typename Ops::value_type;
+    const auto zero{Ops::zero()};
+    transform_activation<Ops>(
+            input, output, size,
+            [zero](auto v) { return Ops::max(zero, v); },
+            [](T x) { return T(0) > x ? T(0) : x; });
+}
+
+template<typename Ops>
+void clipped_relu_kernel(const typename Ops::value_type *input, typename Ops::value_type *output,
+                         std::size_t size, typename Ops::value_type cap) noexcept {
+    using T = typename Ops::value_type;
+    const auto zero{Ops::zero()};
+    const auto capVector{Ops::broadcast(cap)};
+    transform_activation<Ops>(
+            input, output, size,
+            [zero, capVector](auto v) { return Ops::min(capVector, Ops::max(zero, v)); },
+            [cap](T x) {
+                T positive{T(0) > x ? T(0) : x};
+                return cap < positive ? cap : positive;
+            });
+}
+
+template<typename Ops>
+void leaky_relu_kernel(const typename Ops::value_type *input, typename Ops::value_type *output,
+                       std::size_t size, typename Ops::value_type alpha) noexcept {
+    using T = typename Ops::value_type;
+    const auto alphaVector{Ops::broadcast(alpha)};
+    transform_activation<Ops>(
+            input, output, size,
+            [alphaVector](auto v) { return Ops::max(Ops::mul(alphaVector, v), v); },
+            [alpha](T x) {
+                T scaled{alpha * x};
+                return scaled > x ? scaled : x;
+            });
+}
+
+template<typename Ops>
+void sign_mask_kernel(const typename Ops::value_type *input,
+                      sign_mask_t<typename Ops::value_type> *output,
+                      std::size_t size) noexcept {
+    using U = sign_mask_t<typename Ops::value_type>;
+    constexpr int shift{8 * sizeof(U) - 1};
+    transform_activation<Ops>(
+            input, output, size,
+            [](auto v) { return Ops::sign_mask(v); },
+            [](auto x) {
+                U bits;
+                std::memcpy(&bits, &x, sizeof(U));
+                return U(bits >> shift);
+            });
+}
+
+template<typename Ops>
+void relu_quantize_kernel(const float *input, std::int8_t *output, std::size_t size,
+                          float scale, bool nonTemporal) noexcept {
+    constexpr std::size_t lanes{Ops::quantize_lanes};
+    const auto scaleVector{Ops::broadcast(scale)};
+    auto scalarOp {
+        [scale](float x) {
+            float positive{x > 0.0f ? x : 0.0f};
+            float scaled{positive * scale};
+            float clamped{scaled < 127.0f ? scaled : 127.0f};
+            // Rounds half to even for values in [0, 2^23), just like the
+            // conversion instructions using the default rounding mode.
+            return static_cast<std::int8_t>((clamped + 0x1p23f) - 0x1p23f);
+        }
+    };
+
+    const std::size_t misalignment{reinterpret_cast<std::uintptr_t>(output) % lanes};
+    const std::size_t unaligned{misalignment == 0 ? 0 : lanes - misalignment};
+    const std::size_t head{unaligned < size ? unaligned : size};
+
+    std::size_t i{0};
+    for (; i < head; ++i)
+        output[i] = scalarOp(input[i]);
+
+    if (nonTemporal) {
+        for (; i + lanes <= size; i += lanes)
+            Ops::stream(output + i, Ops::relu_quantize(input + i, scaleVector));
+
+        Ops::fence();
+    } else {
+        for (; i + lanes <= size; i += lanes)
+            Ops::store(output + i, Ops::relu_quantize(input + i, scaleVector));
+    }
+
+    for (; i < size; ++i)
+        output[i] = scalarOp(input[i]);
+}
+
+template<template<typename> typename Ops, activation_type T>
+[[nodiscard]] constexpr ActivationKernels<T> make_activation_kernels() noexcept {
+    if constexpr (std::floating_point<T>) {
+        return {relu_kernel<Ops<T>>, clipped_relu_kernel<Ops<T>>,
+                leaky_relu_kernel<Ops<T>>, sign_mask_kernel<Ops<T>>};
+    } else {
+        return {relu_kernel<Ops<T>>, clipped_relu_kernel<Ops<T>>,
+                nullptr, sign_mask_kernel<Ops<T>>};
+    }
+}
+
+template<template<typename> typename Ops>
+[[nodiscard]] constexpr ActivationKernelTable make_activation_kernel_table() noexcept {
+    return {make_activation_kernels<Ops, float>(),
+            make_activation_kernels<Ops, double>(),
+            make_activation_kernels<Ops, std::int8_t>(),
+            make_activation_kernels<Ops, std::int16_t>(),
+            make_activation_kernels<Ops, std::int32_t>(),
+            relu_quantize_kernel<Ops<float>>};
+}
+
+#endif
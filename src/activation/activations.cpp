@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+#include "activations.h"
+#include "activationKernels.h"
+
+/*
+ * The scalar kernels are plain loops, which the compiler auto-vectorises for
+ * the baseline instruction set. They serve as fallback and as reference for
+ * the explicitly vectorised kernels.
+ */
+
+namespace {
+    template<activation_type T>
+    void scalar_relu(const T *input, T *output, std::size_t size) noexcept {
+        for (std::size_t i = 0; i < size; ++i)
+            output[i] = relu_using_max(input[i]);
+    }
+
+    template<activation_type T>
+    void scalar_clipped_relu(const T *input, T *output, std::size_t size, T cap) noexcept {
+        for (std::size_t i = 0; i < size; ++i)
+            output[i] = std::min(relu_using_max(input[i]), cap);
+    }
+
+    template<activation_type T>
+    void scalar_leaky_relu(const T *input, T *output, std::size_t size, T alpha) noexcept {
+        for (std::size_t i = 0; i < size; ++i)
+            output[i] = std::max(input[i], alpha * input[i]);
+    }
+
+    template<activation_type T>
+    void scalar_sign_mask(const T *input, sign_mask_t<T> *output, std::size_t size) noexcept {
+        using U = sign_mask_t<T>;
+        for (std::size_t i = 0; i < size; ++i)
+            output[i] = U(std::bit_cast<U>(input[i]) >> (8 * sizeof(U) - 1));
+    }
+
+    // Unlike relu_using_max, NaNs are mapped to zero, as there is no NaN in int8.
+    void scalar_relu_quantize(const float *input, std::int8_t *output, std::size_t size,
+                              float scale, [[maybe_unused]] bool nonTemporal) noexcept {
+        for (std::size_t i = 0; i < size; ++i) {
+            float positive{input[i] > 0.0f ? input[i] : 0.0f};
+            output[i] = static_cast<std::int8_t>(std::nearbyint(std::min(positive * scale, 127.0f)));
+        }
+    }
+
+    template<activation_type T>
+    [[nodiscard]] constexpr ActivationKernels<T> make_scalar_kernels() noexcept {
+        if constexpr (std::floating_point<T>) {
+            return {scalar_relu<T>, scalar_clipped_relu<T>, scalar_leaky_relu<T>, scalar_sign_mask<T>};
+        } else {
+            return {scalar_relu<T>, scalar_clipped_relu<T>, nullptr, scalar_sign_mask<T>};
+        }
+    }
+
+    constexpr ActivationKernelTable scalar_activation_kernels{
+            make_scalar_kernels<float>(),
+            make_scalar_kernels<double>(),
+            make_scalar_kernels<std::int8_t>(),
+            make_scalar_kernels<std::int16_t>(),
+            make_scalar_kernels<std::int32_t>(),
+            scalar_relu_quantize};
+}
+
+std::string_view to_string(Isa isa) noexcept {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse41: return "SSE4.1";
+        case Isa::Avx2: return "AVX2";
+        case Isa::Avx512: return "AVX-512";
+    }
+
+    return "unknown";
+}
+
+bool is_supported(Isa isa) noexcept {
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::Scalar: return true;
+        case Isa::Sse41: return __builtin_cpu_supports("sse4.1");
+        case Isa::Avx2: return __builtin_cpu_supports("avx2");
+        case Isa::Avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+
+    return false;
+}
+
+Isa best_supported_isa() noexcept {
+    static const Isa best {[] {
+        for (Isa isa : {Isa::Avx512, Isa::Avx2, Isa::Sse41})
+            if (is_supported(isa))
+                return isa;
+
+        return Isa::Scalar;
+    }()};
+
+    return best;
+}
+
+const ActivationKernelTable &activation_kernel_table(Isa isa) {
+    if (!is_supported(isa))
+        throw std::invalid_argument("Instruction set is not supported by this CPU.");
+
+    switch (isa) {
+        case Isa::Sse41: return sse41_activation_kernels;
+        case Isa::Avx2: return avx2_activation_kernels;
+        case Isa::Avx512: return avx512_activation_kernels;
+        default: return scalar_activation_kernels;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef CPPPLAYGROUND_ACTIVATIONS_H
+#define CPPPLAYGROUND_ACTIVATIONS_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "relu.h"
+
+/*
+ * Activation functions applied to whole buffers at once.
+ * Every kernel exists as a plain loop, which the compiler is free to
+ * auto-vectorise for the baseline instruction set, and as explicitly
+ * vectorised SSE4.1, AVX2 and AVX-512 code paths. The fastest code path the
+ * CPU supports is picked at runtime using CPUID.
+ *
+ * Input and output may be the very same buffer, but must not overlap otherwise.
+ * Neither needs to be aligned: The kernels handle unaligned heads and tails
+ * using scalar code and use aligned stores in between.
+ */
+
+template<typename T>
+concept activation_type = plain_signed<T>
+        && (std::same_as<T, float> || std::same_as<T, double>
+            || std::same_as<T, std::int8_t> || std::same_as<T, std::int16_t>
+            || std::same_as<T, std::int32_t>);
+
+// Signed integer with the same width as T, used for the output of sign_mask().
+template<activation_type T>
+using sign_mask_t = std::conditional_t<sizeof(T) == 8, std::int64_t,
+                    std::conditional_t<sizeof(T) == 4, std::int32_t,
+                    std::conditional_t<sizeof(T) == 2, std::int16_t, std::int8_t>>>;
+
+enum class Isa {Scalar, Sse41, Avx2, Avx512};
+
+[[nodiscard]] std::string_view to_string(Isa isa) noexcept;
+
+[[nodiscard]] bool is_supported(Isa isa) noexcept;
+
+[[nodiscard]] Isa best_supported_isa() noexcept;
+
+template<activation_type T>
+struct ActivationKernels final {
+    void (*relu)(const T *input, T *output, std::size_t size) noexcept;
+    void (*clipped_relu)(const T *input, T *output, std::size_t size, T cap) noexcept;
+    // Only available for floating point types, nullptr otherwise.
+    void (*leaky_relu)(const T *input, T *output, std::size_t size, T alpha) noexcept;
+    void (*sign_mask)(const T *input, sign_mask_t<T> *output, std::size_t size) noexcept;
+};
+
+struct ActivationKernelTable final {
+    ActivationKernels<float> f32;
+    ActivationKernels<double> f64;
+    ActivationKernels<std::int8_t> i8;
+    ActivationKernels<std::int16_t> i16;
+    ActivationKernels<std::int32_t> i32;
+    // See quantization.h.
+    void (*relu_quantize)(const float *input, std::int8_t *output, std::size_t size,
+                          float scale, bool nonTemporal) noexcept;
+
+    template<activation_type T>
+    [[nodiscard]] constexpr const ActivationKernels<T> &get() const noexcept {
+        if constexpr (std::same_as<T, float>) {
+            return f32;
+        } else if constexpr (std::same_as<T, double>) {
+            return f64;
+        } else if constexpr (std::same_as<T, std::int8_t>) {
+            return i8;
+        } else if constexpr (std::same_as<T, std::int16_t>) {
+            return i16;
+        } else {
+            return i32;
+        }
+    }
+};
+
+// Throws std::invalid_argument if the given instruction set is not supported.
+[[nodiscard]] const ActivationKernelTable &activation_kernel_table(Isa isa);
+
+template<activation_type T>
+[[nodiscard]] const ActivationKernels<T> &activation_kernels(Isa isa) {
+    return activation_kernel_table(isa).get<T>();
+}
+
+template<typename T, typename U>
+constexpr void verify_activation_sizes(std::span<const T> input, std::span<U> output) {
+    if (input.size() != output.size())
+        throw std::invalid_argument("Input and output of an activation must have the same size.");
+}
+
+// output[i] = max(input[i], 0)
+template<activation_type T>
+void relu(std::span<const T> input, std::type_identity_t<std::span<T>> output, Isa isa = best_supported_isa()) {
+    verify_activation_sizes(input, output);
+    activation_kernels<T>(isa).relu(input.data(), output.data(), input.size());
+}
+
+// output[i] = min(max(input[i], 0), cap), requires cap >= 0.
+template<activation_type T>
+void clipped_relu(std::span<const T> input, std::type_identity_t<std::span<T>> output, T cap, Isa isa = best_supported_isa()) {
+    verify_activation_sizes(input, output);
+    if (!(cap >= T(0)))
+        throw std::invalid_argument("The cap of a clipped ReLU must not be negative.");
+
+    activation_kernels<T>(isa).clipped_relu(input.data(), output.data(), input.size(), cap);
+}
+
+template<activation_type T>
+void relu6(std::span<const T> input, std::type_identity_t<std::span<T>> output, Isa isa = best_supported_isa()) {
+    clipped_relu(input, output, T(6), isa);
+}
+
+// output[i] = max(input[i], alpha * input[i]), requires 0 <= alpha <= 1.
+template<activation_type T>
+    requires std::floating_point<T>
+void leaky_relu(std::span<const T> input, std::type_identity_t<std::span<T>> output, T alpha, Isa isa = best_supported_isa()) {
+    verify_activation_sizes(input, output);
+    if (!(alpha >= T(0) && alpha <= T(1)))
+        throw std::invalid_argument("The slope of a leaky ReLU must be between zero and one.");
+
+    activation_kernels<T>(isa).leaky_relu(input.data(), output.data(), input.size(), alpha);
+}
+
+// output[i] has all bits set if the sign bit of input[i] is set, no bits otherwise.
+template<activation_type T>
+void sign_mask(std::span<const T> input, std::type_identity_t<std::span<sign_mask_t<T>>> output, Isa isa = best_supported_isa()) {
+    verify_activation_sizes(input, output);
+    activation_kernels<T>(isa).sign_mask(input.data(), output.data(), input.size());
+}
+
+#endif
@@ -0,0 +1,129 @@
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+#include "activationKernels.h"
+
+// Compiled with -mavx2, see activationKernels.h.
+
+namespace {
+    template<typename T>
+    struct Ops;
+
+    template<>
+    struct Ops<float> final {
+        using value_type = float;
+        using Vec = __m256;
+        static constexpr std::size_t lanes{8};
+
+        static Vec load(const float *p) noexcept { return _mm256_loadu_ps(p); }
+        static void store(float *p, Vec v) noexcept { _mm256_store_ps(p, v); }
+        static void store(std::int32_t *p, __m256i v) noexcept { _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+        static Vec zero() noexcept { return _mm256_setzero_ps(); }
+        static Vec broadcast(float x) noexcept { return _mm256_set1_ps(x); }
+        static Vec max(Vec a, Vec b) noexcept { return _mm256_max_ps(a, b); }
+        static Vec min(Vec a, Vec b) noexcept { return _mm256_min_ps(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept { return _mm256_mul_ps(a, b); }
+        static __m256i sign_mask(Vec v) noexcept { return _mm256_srai_epi32(_mm256_castps_si256(v), 31); }
+
+        static constexpr std::size_t quantize_lanes{32};
+
+        // max(x, 0) * scale clamped to 127 and rounded to the nearest integer.
+        static __m256i scale_to_int(Vec v, Vec scale) noexcept {
+            Vec scaled{_mm256_mul_ps(_mm256_max_ps(v, _mm256_setzero_ps()), scale)};
+            return _mm256_cvtps_epi32(_mm256_min_ps(scaled, _mm256_set1_ps(127.0f)));
+        }
+
+        // The pack instructions work on each 128 bit lane separately, so the
+        // 32 bit groups have to be put back into order afterwards.
+        static __m256i relu_quantize(const float *p, Vec scale) noexcept {
+            __m256i low{_mm256_packs_epi32(scale_to_int(load(p), scale), scale_to_int(load(p + 8), scale))};
+            __m256i high{_mm256_packs_epi32(scale_to_int(load(p + 16), scale), scale_to_int(load(p + 24), scale))};
+            __m256i packed{_mm256_packs_epi16(low, high)};
+            return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        }
+
+        static void store(std::int8_t *p, __m256i v) noexcept { _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+        static void stream(std::int8_t *p, __m256i v) noexcept { _mm256_stream_si256(reinterpret_cast<__m256i *>(p), v); }
+        static void fence() noexcept { _mm_sfence(); }
+    };
+
+    template<>
+    struct Ops<double> final {
+        using value_type = double;
+        using Vec = __m256d;
+        static constexpr std::size_t lanes{4};
+
+        static Vec load(const double *p) noexcept { return _mm256_loadu_pd(p); }
+        static void store(double *p, Vec v) noexcept { _mm256_store_pd(p, v); }
+        static void store(std::int64_t *p, __m256i v) noexcept { _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+        static Vec zero() noexcept { return _mm256_setzero_pd(); }
+        static Vec broadcast(double x) noexcept { return _mm256_set1_pd(x); }
+        static Vec max(Vec a, Vec b) noexcept { return _mm256_max_pd(a, b); }
+        static Vec min(Vec a, Vec b) noexcept { return _mm256_min_pd(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept { return _mm256_mul_pd(a, b); }
+
+        // There is no 64 bit arithmetic shift, so shift the upper halves and
+        // copy them into the lower halves.
+        static __m256i sign_mask(Vec v) noexcept {
+            __m256i shifted{_mm256_srai_epi32(_mm256_castpd_si256(v), 31)};
+            return _mm256_shuffle_epi32(shifted, _MM_SHUFFLE(3, 3, 1, 1));
+        }
+    };
+
+    template<std::signed_integral T>
+    struct Ops<T> final {
+        using value_type = T;
+        using Vec = __m256i;
+        static constexpr std::size_t lanes{sizeof(Vec) / sizeof(T)};
+
+        static Vec load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        static void store(T *p, Vec v) noexcept { _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+        static Vec zero() noexcept { return _mm256_setzero_si256(); }
+
+        static Vec broadcast(T x) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm256_set1_epi8(x);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_set1_epi16(x);
+            } else {
+                return _mm256_set1_epi32(x);
+            }
+        }
+
+        static Vec max(Vec a, Vec b) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm256_max_epi8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_max_epi16(a, b);
+            } else {
+                return _mm256_max_epi32(a, b);
+            }
+        }
+
+        static Vec min(Vec a, Vec b) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm256_min_epi8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_min_epi16(a, b);
+            } else {
+                return _mm256_min_epi32(a, b);
+            }
+        }
+
+        // There is no 8 bit arithmetic shift, but comparing against zero does the same.
+        static Vec sign_mask(Vec v) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm256_cmpgt_epi8(_mm256_setzero_si256(), v);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_srai_epi16(v, 15);
+            } else {
+                return _mm256_srai_epi32(v, 31);
+            }
+        }
+    };
+}
+
+extern const ActivationKernelTable avx2_activation_kernels{make_activation_kernel_table<Ops>()};
@@ -0,0 +1,123 @@
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+#include "activationKernels.h"
+
+// Compiled with -mavx512f -mavx512bw, see activationKernels.h.
+
+namespace {
+    template<typename T>
+    struct Ops;
+
+    template<>
+    struct Ops<float> final {
+        using value_type = float;
+        using Vec = __m512;
+        static constexpr std::size_t lanes{16};
+
+        static Vec load(const float *p) noexcept { return _mm512_loadu_ps(p); }
+        static void store(float *p, Vec v) noexcept { _mm512_store_ps(p, v); }
+        static void store(std::int32_t *p, __m512i v) noexcept { _mm512_store_si512(p, v); }
+        static Vec zero() noexcept { return _mm512_setzero_ps(); }
+        static Vec broadcast(float x) noexcept { return _mm512_set1_ps(x); }
+        static Vec max(Vec a, Vec b) noexcept { return _mm512_max_ps(a, b); }
+        static Vec min(Vec a, Vec b) noexcept { return _mm512_min_ps(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept { return _mm512_mul_ps(a, b); }
+        static __m512i sign_mask(Vec v) noexcept { return _mm512_srai_epi32(_mm512_castps_si512(v), 31); }
+
+        static constexpr std::size_t quantize_lanes{64};
+
+        // max(x, 0) * scale clamped to 127, rounded to the nearest integer and
+        // narrowed to 8 bit.
+        static __m128i scale_to_int8(Vec v, Vec scale) noexcept {
+            Vec scaled{_mm512_mul_ps(_mm512_max_ps(v, _mm512_setzero_ps()), scale)};
+            return _mm512_cvtsepi32_epi8(_mm512_cvtps_epi32(_mm512_min_ps(scaled, _mm512_set1_ps(127.0f))));
+        }
+
+        static __m512i relu_quantize(const float *p, Vec scale) noexcept {
+            __m512i result{_mm512_castsi128_si512(scale_to_int8(load(p), scale))};
+            result = _mm512_inserti32x4(result, scale_to_int8(load(p + 16), scale), 1);
+            result = _mm512_inserti32x4(result, scale_to_int8(load(p + 32), scale), 2);
+            return _mm512_inserti32x4(result, scale_to_int8(load(p + 48), scale), 3);
+        }
+
+        static void store(std::int8_t *p, __m512i v) noexcept { _mm512_store_si512(p, v); }
+        static void stream(std::int8_t *p, __m512i v) noexcept { _mm512_stream_si512(reinterpret_cast<__m512i *>(p), v); }
+        static void fence() noexcept { _mm_sfence(); }
+    };
+
+    template<>
+    struct Ops<double> final {
+        using value_type = double;
+        using Vec = __m512d;
+        static constexpr std::size_t lanes{8};
+
+        static Vec load(const double *p) noexcept { return _mm512_loadu_pd(p); }
+        static void store(double *p, Vec v) noexcept { _mm512_store_pd(p, v); }
+        static void store(std::int64_t *p, __m512i v) noexcept { _mm512_store_si512(p, v); }
+        static Vec zero() noexcept { return _mm512_setzero_pd(); }
+        static Vec broadcast(double x) noexcept { return _mm512_set1_pd(x); }
+        static Vec max(Vec a, Vec b) noexcept { return _mm512_max_pd(a, b); }
+        static Vec min(Vec a, Vec b) noexcept { return _mm512_min_pd(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept { return _mm512_mul_pd(a, b); }
+        static __m512i sign_mask(Vec v) noexcept { return _mm512_srai_epi64(_mm512_castpd_si512(v), 63); }
+    };
+
+    template<std::signed_integral T>
+    struct Ops<T> final {
+        using value_type = T;
+        using Vec = __m512i;
+        static constexpr std::size_t lanes{sizeof(Vec) / sizeof(T)};
+
+        static Vec load(const T *p) noexcept { return _mm512_loadu_si512(p); }
+        static void store(T *p, Vec v) noexcept { _mm512_store_si512(p, v); }
+        static Vec zero() noexcept { return _mm512_setzero_si512(); }
+
+        static Vec broadcast(T x) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm512_set1_epi8(x);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm512_set1_epi16(x);
+            } else {
+                return _mm512_set1_epi32(x);
+            }
+        }
+
+        static Vec max(Vec a, Vec b) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm512_max_epi8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm512_max_epi16(a, b);
+            } else {
+                return _mm512_max_epi32(a, b);
+            }
+        }
+
+        static Vec min(Vec a, Vec b) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm512_min_epi8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm512_min_epi16(a, b);
+            } else {
+                return _mm512_min_epi32(a, b);
+            }
+        }
+
+        // There is no 8 bit arithmetic shift, but the sign bits can be moved
+        // into a mask register and expanded again.
+        static Vec sign_mask(Vec v) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm512_movm_epi8(_mm512_movepi8_mask(v));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm512_srai_epi16(v, 15);
+            } else {
+                return _mm512_srai_epi32(v, 31);
+            }
+        }
+    };
+}
+
+extern const ActivationKernelTable avx512_activation_kernels{make_activation_kernel_table<Ops>()};
@@ -0,0 +1,126 @@
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+#include "activationKernels.h"
+
+// Compiled with -msse4.1, see activationKernels.h.
+
+namespace {
+    template<typename T>
+    struct Ops;
+
+    template<>
+    struct Ops<float> final {
+        using value_type = float;
+        using Vec = __m128;
+        static constexpr std::size_t lanes{4};
+
+        static Vec load(const float *p) noexcept { return _mm_loadu_ps(p); }
+        static void store(float *p, Vec v) noexcept { _mm_store_ps(p, v); }
+        static void store(std::int32_t *p, __m128i v) noexcept { _mm_store_si128(reinterpret_cast<__m128i *>(p), v); }
+        static Vec zero() noexcept { return _mm_setzero_ps(); }
+        static Vec broadcast(float x) noexcept { return _mm_set1_ps(x); }
+        static Vec max(Vec a, Vec b) noexcept { return _mm_max_ps(a, b); }
+        static Vec min(Vec a, Vec b) noexcept { return _mm_min_ps(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept { return _mm_mul_ps(a, b); }
+        static __m128i sign_mask(Vec v) noexcept { return _mm_srai_epi32(_mm_castps_si128(v), 31); }
+
+        static constexpr std::size_t quantize_lanes{16};
+
+        // max(x, 0) * scale clamped to 127 and rounded to the nearest integer.
+        static __m128i scale_to_int(Vec v, Vec scale) noexcept {
+            Vec scaled{_mm_mul_ps(_mm_max_ps(v, _mm_setzero_ps()), scale)};
+            return _mm_cvtps_epi32(_mm_min_ps(scaled, _mm_set1_ps(127.0f)));
+        }
+
+        static __m128i relu_quantize(const float *p, Vec scale) noexcept {
+            __m128i low{_mm_packs_epi32(scale_to_int(load(p), scale), scale_to_int(load(p + 4), scale))};
+            __m128i high{_mm_packs_epi32(scale_to_int(load(p + 8), scale), scale_to_int(load(p + 12), scale))};
+            return _mm_packs_epi16(low, high);
+        }
+
+        static void store(std::int8_t *p, __m128i v) noexcept { _mm_store_si128(reinterpret_cast<__m128i *>(p), v); }
+        static void stream(std::int8_t *p, __m128i v) noexcept { _mm_stream_si128(reinterpret_cast<__m128i *>(p), v); }
+        static void fence() noexcept { _mm_sfence(); }
+    };
+
+    template<>
+    struct Ops<double> final {
+        using value_type = double;
+        using Vec = __m128d;
+        static constexpr std::size_t lanes{2};
+
+        static Vec load(const double *p) noexcept { return _mm_loadu_pd(p); }
+        static void store(double *p, Vec v) noexcept { _mm_store_pd(p, v); }
+        static void store(std::int64_t *p, __m128i v) noexcept { _mm_store_si128(reinterpret_cast<__m128i *>(p), v); }
+        static Vec zero() noexcept { return _mm_setzero_pd(); }
+        static Vec broadcast(double x) noexcept { return _mm_set1_pd(x); }
+        static Vec max(Vec a, Vec b) noexcept { return _mm_max_pd(a, b); }
+        static Vec min(Vec a, Vec b) noexcept { return _mm_min_pd(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept { return _mm_mul_pd(a, b); }
+
+        // There is no 64 bit arithmetic shift, so shift the upper halves and
+        // copy them into the lower halves.
+        static __m128i sign_mask(Vec v) noexcept {
+            __m128i shifted{_mm_srai_epi32(_mm_castpd_si128(v), 31)};
+            return _mm_shuffle_epi32(shifted, _MM_SHUFFLE(3, 3, 1, 1));
+        }
+    };
+
+    template<std::signed_integral T>
+    struct Ops<T> final {
+        using value_type = T;
+        using Vec = __m128i;
+        static constexpr std::size_t lanes{sizeof(Vec) / sizeof(T)};
+
+        static Vec load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        static void store(T *p, Vec v) noexcept { _mm_store_si128(reinterpret_cast<__m128i *>(p), v); }
+        static Vec zero() noexcept { return _mm_setzero_si128(); }
+
+        static Vec broadcast(T x) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_set1_epi8(x);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_set1_epi16(x);
+            } else {
+                return _mm_set1_epi32(x);
+            }
+        }
+
+        static Vec max(Vec a, Vec b) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_max_epi8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_max_epi16(a, b);
+            } else {
+                return _mm_max_epi32(a, b);
+            }
+        }
+
+        static Vec min(Vec a, Vec b) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_min_epi8(a, b);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_min_epi16(a, b);
+            } else {
+                return _mm_min_epi32(a, b);
+            }
+        }
+
+        // There is no 8 bit arithmetic shift, but comparing against zero does the same.
+        static Vec sign_mask(Vec v) noexcept {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_cmplt_epi8(v, _mm_setzero_si128());
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_srai_epi16(v, 15);
+            } else {
+                return _mm_srai_epi32(v, 31);
+            }
+        }
+    };
+}
+
+extern const ActivationKernelTable sse41_activation_kernels{make_activation_kernel_table<Ops>()};
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "quantization.h"
+
+namespace {
+    // Each thread gets at least 256 KiB of input, otherwise starting it costs
+    // more than it saves.
+    constexpr std::size_t min_elements_per_thread{1 << 16};
+
+    // Chunks start on a cache line of the output, measured from its actual
+    // address, so that no two threads write the same cache line.
+    constexpr std::size_t chunk_alignment{64};
+
+    constexpr std::size_t fallback_cache_size{8 * 1024 * 1024};
+}
+
+std::size_t last_level_cache_size() noexcept {
+    static const std::size_t size {[] {
+        for (int level : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE}) {
+            long bytes{sysconf(level)};
+            if (bytes > 0)
+                return static_cast<std::size_t>(bytes);
+        }
+
+        return fallback_cache_size;
+    }()};
+
+    return size;
+}
+
+void relu_quantize(std::span<const float> input, std::span<std::int8_t> output,
+                   float scale, ReluQuantizeOptions options) {
+    verify_activation_sizes(input, output);
+    if (!(std::isfinite(scale) && scale > 0.0f))
+        throw std::invalid_argument("The scale of a quantization must be positive and finite.");
+
+    auto kernel{activation_kernel_table(options.isa).relu_quantize};
+    bool nonTemporal{options.nonTemporalStores.value_or(output.size_bytes() > last_level_cache_size())};
+
+    std::size_t threads{std::clamp<std::size_t>(input.size() / min_elements_per_thread, 1, std::max<std::size_t>(options.threads, 1))};
+    std::size_t chunk{(input.size() / threads + chunk_alignment - 1) / chunk_alignment * chunk_alignment};
+
+    std::vector<std::jthread> workers;
+    workers.reserve(threads - 1);
+    // The first chunk is shortened by the misalignment, as chunk is a multiple of the alignment.
+    std::size_t misalignment{reinterpret_cast<std::uintptr_t>(output.data()) % chunk_alignment};
+    std::size_t begin{0};
+    for (std::size_t i = 1; i < threads && begin < input.size(); ++i) {
+        std::size_t end{std::min(i * chunk - misalignment, input.size())};
+        workers.emplace_back(kernel, input.data() + begin, output.data() + begin, end - begin, scale, nonTemporal);
+        begin = end;
+    }
+
+    if (begin < input.size())
+        kernel(input.data() + begin, output.data() + begin, input.size() - begin, scale, nonTemporal);
+}
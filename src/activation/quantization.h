@@ -0,0 +1,37 @@
+#ifndef CPPPLAYGROUND_QUANTIZATION_H
+#define CPPPLAYGROUND_QUANTIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <thread>
+
+#include "activations.h"
+
+/*
+ * Fused ReLU, scaling and int8 quantization:
+ * `output[i] = saturate_int8(round(max(input[i], 0) * scale))`
+ * NaNs are mapped to zero and rounding is to the nearest integer, ties to even.
+ *
+ * Doing all of this in a single streaming pass reads the input once and
+ * writes the int8 output once, instead of reading and writing a float buffer
+ * per step. Outputs larger than the last level cache are written using
+ * non-temporal stores, so that they do not evict the input from the cache.
+ * Large buffers are split across threads.
+ */
+
+struct ReluQuantizeOptions final {
+    Isa isa{best_supported_isa()};
+    std::size_t threads{std::thread::hardware_concurrency()};
+    // Decided by comparing the size of the output to the last level cache if empty.
+    std::optional<bool> nonTemporalStores{};
+};
+
+// Size of the last level cache in bytes, or a guess if it cannot be determined.
+[[nodiscard]] std::size_t last_level_cache_size() noexcept;
+
+void relu_quantize(std::span<const float> input, std::span<std::int8_t> output,
+                   float scale, ReluQuantizeOptions options = {});
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef CPPPLAYGROUND_RELU_H
+#define CPPPLAYGROUND_RELU_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <type_traits>
+
+template<typename T>
+concept plain_signed = std::is_signed_v<T> && (!std::is_const_v<T>)
+                                           && (!std::is_volatile_v<T>);
+
+template<plain_signed T>
+[[nodiscard]]constexpr T relu_using_max(T n) noexcept {
+    return std::max<T>(n, T(0));
+}
+
+template<plain_signed T>
+[[nodiscard]]constexpr T relu_bit_twiddle(T n) noexcept {
+    using U = std::make_unsigned_t<T>;
+    U n_unsigned {std::bit_cast<U, T>(n)};
+    bool is_negative {std::signbit(n)};
+    U mask {U(0) - U(!is_negative)};
+    return n_unsigned & mask;
+}
+
+#endif
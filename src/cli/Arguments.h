@@ -0,0 +1,123 @@
+#ifndef CPPPLAYGROUND_ARGUMENTS_H
+#define CPPPLAYGROUND_ARGUMENTS_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "CliErrors.h"
+
+inline constexpr std::string_view usage {
+    "Usage: cppplayground [--stats] [--threads COUNT] [--input FILE] [--output FILE]\n"
+    "                     OPERATION\n"
+    "\n"
+    "Reads one multinomial opinion per line, applies OPERATION to each and\n"
+    "writes the results one per line. Input and output default to stdin and\n"
+    "stdout, '-' selects them explicitly.\n"
+    "\n"
+    "A multinomial opinion of size n is written as 2n + 1 numbers separated by\n"
+    "whitespace: uncertainty, n beliefs, n apriories. A binomial opinion is\n"
+    "written as belief, disbelief, uncertainty and apriori. Empty lines and\n"
+    "lines starting with '#' are skipped.\n"
+    "\n"
+    "Operations:\n"
+    "  coarsen INDEX     Coarsen to a binomial opinion about category INDEX.\n"
+    "  make-static SIZE  Convert to an opinion of static size SIZE (2 to 16).\n"
+    "  make-dynamic      Convert to an opinion of dynamic size.\n"
+    "\n"
+    "Options:\n"
+    "  --stats           Report the throughput to stderr.\n"
+    "  --threads COUNT   Number of threads processing records, defaults to the\n"
+    "                    number of hardware threads.\n"
+};
+
+enum class Operation {Coarsen, MakeStatic, MakeDynamic};
+
+struct Arguments final {
+    std::optional<std::string_view> input{};
+    std::optional<std::string_view> output{};
+    bool stats{false};
+    std::size_t threads{std::max(1u, std::thread::hardware_concurrency())};
+    Operation operation{Operation::MakeDynamic};
+    // Category for Coarsen, size for MakeStatic.
+    std::size_t operand{0};
+};
+
+[[nodiscard]] inline std::size_t parse_operand(std::string_view name, std::string_view text) {
+    std::size_t value{};
+    auto [end, error] {std::from_chars(text.data(), text.data() + text.size(), value)};
+    if (error != std::errc{} || end != text.data() + text.size())
+        throw UsageError{"Invalid argument for " + std::string{name} + ": '" + std::string{text} + "'."};
+
+    return value;
+}
+
+// Expects the arguments without the name of the program.
+template<std::ranges::random_access_range R>
+    requires std::same_as<std::ranges::range_value_t<R>, std::string_view>
+[[nodiscard]] Arguments parse_arguments(R args) {
+    Arguments arguments{};
+    std::optional<std::string_view> operation{};
+    std::optional<std::string_view> operand{};
+
+    for (auto it {std::ranges::begin(args)}; it != std::ranges::end(args); ++it) {
+        std::string_view arg{*it};
+        auto value {
+            [&]() -> std::string_view {
+                if (++it == std::ranges::end(args))
+                    throw UsageError{"Missing value for " + std::string{arg} + "."};
+
+                return *it;
+            }
+        };
+
+        if (arg == "--stats") {
+            arguments.stats = true;
+        } else if (arg == "--input") {
+            arguments.input = value();
+        } else if (arg == "--output") {
+            arguments.output = value();
+        } else if (arg == "--threads") {
+            arguments.threads = parse_operand(arg, value());
+            if (arguments.threads == 0)
+                throw UsageError{"At least one thread is needed."};
+        } else if (arg.starts_with("--")) {
+            throw UsageError{"Unknown option " + std::string{arg} + "."};
+        } else if (!operation) {
+            operation = arg;
+        } else if (!operand) {
+            operand = arg;
+        } else {
+            throw UsageError{"Unexpected argument '" + std::string{arg} + "'."};
+        }
+    }
+
+    if (!operation)
+        throw UsageError{"Missing operation."};
+
+    bool needsOperand{*operation == "coarsen" || *operation == "make-static"};
+    if (needsOperand != operand.has_value())
+        throw UsageError{std::string{needsOperand ? "Missing" : "Unexpected"} + " argument for " + std::string{*operation} + "."};
+
+    if (*operation == "coarsen") {
+        arguments.operation = Operation::Coarsen;
+        arguments.operand = parse_operand(*operation, *operand);
+    } else if (*operation == "make-static") {
+        arguments.operation = Operation::MakeStatic;
+        arguments.operand = parse_operand(*operation, *operand);
+    } else if (*operation == "make-dynamic") {
+        arguments.operation = Operation::MakeDynamic;
+    } else {
+        throw UsageError{"Unknown operation " + std::string{*operation} + "."};
+    }
+
+    return arguments;
+}
+
+#endif
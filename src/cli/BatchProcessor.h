@@ -0,0 +1,96 @@
+#ifndef CPPPLAYGROUND_BATCHPROCESSOR_H
+#define CPPPLAYGROUND_BATCHPROCESSOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Arguments.h"
+#include "CliErrors.h"
+#include "OpinionRecords.h"
+#include "../subjective_logic/Operations.h"
+
+inline constexpr std::size_t min_static_size{2};
+inline constexpr std::size_t max_static_size{16};
+
+struct BatchStats final {
+    std::size_t records{0};
+    std::size_t bytes{0};
+    std::chrono::steady_clock::duration elapsed{};
+};
+
+inline std::ostream &operator<<(std::ostream &os, const BatchStats &stats) {
+    double seconds{std::chrono::duration<double>(stats.elapsed).count()};
+    double recordsPerSecond{seconds > 0.0 ? static_cast<double>(stats.records) / seconds : 0.0};
+    double megabytesPerSecond{seconds > 0.0 ? static_cast<double>(stats.bytes) / seconds / 1e6 : 0.0};
+    return (os << "records: " << stats.records
+               << ", seconds: " << seconds
+               << ", records/s: " << recordsPerSecond
+               << ", MB/s: " << megabytesPerSecond);
+}
+
+// Calls f.template operator()<N>() with N == size, for sizes between
+// min_static_size and max_static_size.
+template<typename F, std::size_t N = min_static_size>
+decltype(auto) with_static_size(std::size_t size, F &&f) {
+    if constexpr (N < max_static_size) {
+        if (size != N)
+            return with_static_size<F, N + 1>(size, std::forward<F>(f));
+    }
+
+    return std::forward<F>(f).template operator()<N>();
+}
+
+// Applies the operation to a single record and appends the result to out.
+inline void process_record(const Arguments &arguments, Record record,
+                           std::vector<double> &scratch, std::string &out) {
+    auto opinion{parse_record(record, scratch)};
+
+    try {
+        switch (arguments.operation) {
+            case Operation::Coarsen:
+                append_opinion(out, coarsen(opinion, arguments.operand));
+                break;
+            case Operation::MakeStatic:
+                with_static_size(arguments.operand, [&]<std::size_t N>() {
+                    append_opinion(out, make_static<double, N>(opinion));
+                });
+                break;
+            case Operation::MakeDynamic:
+                append_opinion(out, opinion);
+                break;
+        }
+    } catch (const std::invalid_argument &e) {
+        throw InvalidRecordError{record.line, e.what()};
+    }
+}
+
+inline void verify_operand(const Arguments &arguments) {
+    if (arguments.operation == Operation::MakeStatic
+        && (arguments.operand < min_static_size || arguments.operand > max_static_size))
+        throw UsageError{"Static sizes must be between " + std::to_string(min_static_size)
+                         + " and " + std::to_string(max_static_size) + "."};
+}
+
+// Processes all records in text and appends the results to out.
+// Returns the number of records.
+inline std::size_t process_text(const Arguments &arguments, std::string_view text,
+                                std::size_t firstLine, std::string &out) {
+    std::size_t records{0};
+    RecordReader reader{text, firstLine};
+    std::vector<double> scratch{};
+    while (auto record{reader.next()}) {
+        process_record(arguments, *record, scratch, out);
+        ++records;
+    }
+
+    return records;
+}
+
+#endif
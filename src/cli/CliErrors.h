@@ -0,0 +1,40 @@
+#ifndef CPPPLAYGROUND_CLIERRORS_H
+#define CPPPLAYGROUND_CLIERRORS_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/*
+ * Each class of failure of the batch tool has its own exception type, which
+ * newMain() maps to a distinct exit code.
+ */
+
+class UsageError final : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class InputError final : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class OutputError final : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class ParseError final : public std::runtime_error {
+public:
+    ParseError(std::size_t line, const std::string &what)
+        : std::runtime_error{"Line " + std::to_string(line) + ": " + what} {}
+};
+
+class InvalidRecordError final : public std::runtime_error {
+public:
+    InvalidRecordError(std::size_t line, const std::string &what)
+        : std::runtime_error{"Line " + std::to_string(line) + ": " + what} {}
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef CPPPLAYGROUND_INPUTTEXT_H
+#define CPPPLAYGROUND_INPUTTEXT_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CliErrors.h"
+
+/*
+ * The input of the batch tool.
+ * Regular files are mapped into memory and available as one contiguous piece
+ * of text. Everything else (like pipes) has to be read piece by piece.
+ */
+class InputText final {
+public:
+    // Reads from stdin if no path is given or the path is "-".
+    [[nodiscard]] explicit InputText(std::optional<std::string_view> path) {
+        ownsFd = path && *path != "-";
+        fd = ownsFd ? ::open(std::string{*path}.c_str(), O_RDONLY | O_CLOEXEC) : STDIN_FILENO;
+        if (fd < 0)
+            throw InputError{"Cannot open " + std::string{*path} + ": " + std::strerror(errno)};
+
+        tryMap();
+    }
+
+    InputText(const InputText &) = delete;
+    InputText &operator=(const InputText &) = delete;
+
+    ~InputText() noexcept {
+        if (mapped != nullptr)
+            ::munmap(mapped, mappedSize);
+
+        if (ownsFd)
+            ::close(fd);
+    }
+
+    [[nodiscard]] bool isMapped() const noexcept {
+        return mapped != nullptr;
+    }
+
+    // The whole input, only available if isMapped().
+    [[nodiscard]] std::string_view text() const noexcept {
+        return {static_cast<const char *>(mapped), mappedSize};
+    }
+
+    // Reads up to buffer.size() bytes for inputs that are not mapped.
+    // Returns zero at the end of the input.
+    [[nodiscard]] std::size_t read(std::span<char> buffer) {
+        while (true) {
+            ssize_t count{::read(fd, buffer.data(), buffer.size())};
+            if (count >= 0)
+                return static_cast<std::size_t>(count);
+
+            if (errno != EINTR)
+                throw InputError{std::string{"Cannot read input: "} + std::strerror(errno)};
+        }
+    }
+
+private:
+    void tryMap() noexcept {
+        struct stat status{};
+        if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size == 0)
+            return;
+
+        void *address{::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0)};
+        if (address == MAP_FAILED)
+            return;
+
+        ::madvise(address, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+        mapped = address;
+        mappedSize = static_cast<std::size_t>(status.st_size);
+    }
+
+    bool ownsFd{false};
+    int fd{-1};
+    void *mapped{nullptr};
+    std::size_t mappedSize{0};
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef CPPPLAYGROUND_OPINIONRECORDS_H
+#define CPPPLAYGROUND_OPINIONRECORDS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "CliErrors.h"
+#include "../subjective_logic/MultinomialOpinion.h"
+#include "../subjective_logic/OpinionText.h"
+
+struct Record final {
+    std::string_view text;
+    std::size_t line;
+};
+
+// Splits text into records, skipping empty lines and lines starting with '#'.
+class RecordReader final {
+public:
+    // firstLine is the number of the line the text starts with.
+    [[nodiscard]] explicit constexpr RecordReader(std::string_view text, std::size_t firstLine = 1) noexcept
+        : remaining{text}, lineNumber{firstLine - 1} {}
+
+    [[nodiscard]] constexpr std::optional<Record> next() noexcept {
+        while (!remaining.empty()) {
+            std::size_t end{remaining.find('\n')};
+            std::string_view line{remaining.substr(0, end)};
+            remaining.remove_prefix(end == std::string_view::npos ? remaining.size() : end + 1);
+            ++lineNumber;
+
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            std::size_t first{line.find_first_not_of(" \t")};
+            if (first == std::string_view::npos || line[first] == '#')
+                continue;
+
+            return Record{line, lineNumber};
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    std::string_view remaining;
+    std::size_t lineNumber;
+};
+
+// Parses a record as a multinomial opinion of dynamic size.
+[[nodiscard]] inline MultinomialOpinion<double, std::dynamic_extent>
+parse_record(Record record, std::vector<double> &scratch) {
+    const char *const first{record.text.data()};
+    const char *const last{first + record.text.size()};
+    try {
+        auto [ptr, ec, opinion] {parse_multinomial<double, std::dynamic_extent>(first, last, scratch)};
+        if (ec == std::errc{})
+            return std::move(*opinion);
+
+        if (ptr == last)
+            throw ParseError{record.line, "Expected an uncertainty followed by as many beliefs as apriories, but got "
+                                          + std::to_string(scratch.size()) + " numbers."};
+
+        const char *token{skip_number_separators(ptr, last)};
+        throw ParseError{record.line, "Invalid number '" + std::string{token, std::find_if(token, last, is_number_separator)} + "'."};
+    } catch (const std::invalid_argument &e) {
+        throw InvalidRecordError{record.line, e.what()};
+    }
+}
+
+template<text_formattable_opinion Opinion>
+void append_opinion(std::string &out, const Opinion &opinion) {
+    format_opinions(std::span{&opinion, 1}, out);
+}
+
+#endif
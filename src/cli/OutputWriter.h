@@ -0,0 +1,74 @@
+#ifndef CPPPLAYGROUND_OUTPUTWRITER_H
+#define CPPPLAYGROUND_OUTPUTWRITER_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "CliErrors.h"
+
+// Writes text to a file or stdout in large blocks.
+class OutputWriter final {
+public:
+    static constexpr std::size_t flushThreshold{1 << 20};
+
+    // Writes to stdout if no path is given or the path is "-".
+    [[nodiscard]] explicit OutputWriter(std::optional<std::string_view> path)
+        : ownsFd{path && *path != "-"} {
+        fd = ownsFd ? ::open(std::string{*path}.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : STDOUT_FILENO;
+        if (fd < 0)
+            throw OutputError{"Cannot open " + std::string{*path} + ": " + std::strerror(errno)};
+
+        buffer.reserve(flushThreshold + (flushThreshold >> 4));
+    }
+
+    OutputWriter(const OutputWriter &) = delete;
+    OutputWriter &operator=(const OutputWriter &) = delete;
+
+    ~OutputWriter() noexcept {
+        if (ownsFd)
+            ::close(fd);
+    }
+
+    void write(std::string_view text) {
+        if (buffer.empty() && text.size() >= flushThreshold) {
+            writeAll(text);
+            return;
+        }
+
+        buffer += text;
+        if (buffer.size() >= flushThreshold)
+            flush();
+    }
+
+    void flush() {
+        writeAll(buffer);
+        buffer.clear();
+    }
+
+private:
+    void writeAll(std::string_view text) {
+        while (!text.empty()) {
+            ssize_t count{::write(fd, text.data(), text.size())};
+            if (count < 0 && errno == EINTR)
+                continue;
+
+            if (count < 0)
+                throw OutputError{std::string{"Cannot write output: "} + std::strerror(errno)};
+
+            text.remove_prefix(static_cast<std::size_t>(count));
+        }
+    }
+
+    bool ownsFd;
+    int fd;
+    std::string buffer{};
+};
+
+#endif
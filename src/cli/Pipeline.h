@@ -0,0 +1,257 @@
+#ifndef CPPPLAYGROUND_PIPELINE_H
+#define CPPPLAYGROUND_PIPELINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Arguments.h"
+#include "BatchProcessor.h"
+#include "InputText.h"
+#include "OutputWriter.h"
+#include "../patterns/SpscQueue.h"
+
+/*
+ * The batch tool runs as a pipeline of three stages:
+ * A reader thread cuts the input into batches of whole lines, a pool of
+ * workers processes the records and a writer thread writes the results.
+ *
+ * The stages are linked by bounded single-producer/single-consumer queues,
+ * one pair per worker. The reader hands out batch i to worker i % workers and
+ * the writer collects batch i from that very worker, so the output keeps the
+ * order of the input without any reordering buffer. Full queues stall the
+ * stage in front of them, which bounds the memory in flight.
+ *
+ * Failures travel through the pipeline as part of a batch. Thus the writer
+ * sees them in order, writes everything that came before and then stops the
+ * other stages.
+ */
+
+inline constexpr std::size_t pipeline_batch_bytes{1 << 20};
+inline constexpr std::size_t pipeline_queue_capacity{4};
+
+struct InputBatch final {
+    std::size_t firstLine{1};
+    // Batches point into the mapped input if possible and own their text otherwise.
+    std::string_view mapped{};
+    std::string owned{};
+    bool isMapped{false};
+    std::exception_ptr error{};
+
+    [[nodiscard]] std::string_view text() const noexcept {
+        return isMapped ? mapped : std::string_view{owned};
+    }
+};
+
+struct OutputBatch final {
+    std::size_t records{0};
+    std::string text{};
+    std::exception_ptr error{};
+};
+
+using InputQueues = std::deque<SpscQueue<InputBatch>>;
+using OutputQueues = std::deque<SpscQueue<OutputBatch>>;
+
+class BatchReader final {
+public:
+    [[nodiscard]] BatchReader(InputText &input, InputQueues &queues, std::stop_token stop) noexcept
+        : input{input}, queues{queues}, stop{std::move(stop)} {}
+
+    // Returns the number of bytes read.
+    std::size_t operator()() {
+        try {
+            if (input.isMapped()) {
+                readMapped();
+            } else {
+                readStream();
+            }
+        } catch (...) {
+            InputBatch batch{};
+            batch.error = std::current_exception();
+            std::ignore = push(std::move(batch));
+        }
+
+        for (auto &queue : queues)
+            queue.close();
+
+        return bytes;
+    }
+
+private:
+    void readMapped() {
+        std::string_view text{input.text()};
+        while (!text.empty()) {
+            std::size_t newline{text.find('\n', std::min(pipeline_batch_bytes, text.size()) - 1)};
+            std::size_t end{newline == std::string_view::npos ? text.size() : newline + 1};
+
+            InputBatch batch{};
+            batch.mapped = text.substr(0, end);
+            batch.isMapped = true;
+            if (!push(std::move(batch)))
+                return;
+
+            text.remove_prefix(end);
+        }
+    }
+
+    void readStream() {
+        std::string carry{};
+        bool endOfInput{false};
+        while (!endOfInput) {
+            std::string buffer{std::move(carry)};
+            carry.clear();
+
+            std::size_t filled{buffer.size()};
+            buffer.resize(filled + pipeline_batch_bytes);
+            while (filled < buffer.size()) {
+                std::size_t count{input.read(std::span(buffer).subspan(filled))};
+                if (count == 0) {
+                    endOfInput = true;
+                    break;
+                }
+
+                filled += count;
+            }
+
+            buffer.resize(filled);
+            if (!endOfInput) {
+                // Keep the incomplete last line for the next batch. Lines longer
+                // than a batch simply make the next batch larger.
+                std::size_t newline{buffer.rfind('\n')};
+                if (newline == std::string::npos) {
+                    carry = std::move(buffer);
+                    continue;
+                }
+
+                carry.assign(buffer, newline + 1);
+                buffer.resize(newline + 1);
+            }
+
+            if (buffer.empty())
+                continue;
+
+            InputBatch batch{};
+            batch.owned = std::move(buffer);
+            if (!push(std::move(batch)))
+                return;
+        }
+    }
+
+    // Counting the lines touches every page of the batch, so page faults of
+    // the mapped input are taken here and not in the workers.
+    [[nodiscard]] bool push(InputBatch batch) {
+        std::string_view text{batch.text()};
+        batch.firstLine = nextLine;
+        nextLine += static_cast<std::size_t>(std::ranges::count(text, '\n'));
+        bytes += text.size();
+        return queues[sequence++ % queues.size()].push(std::move(batch), stop);
+    }
+
+    InputText &input;
+    InputQueues &queues;
+    std::stop_token stop;
+    std::size_t sequence{0};
+    std::size_t nextLine{1};
+    std::size_t bytes{0};
+};
+
+inline void process_batches(const Arguments &arguments, SpscQueue<InputBatch> &input,
+                            SpscQueue<OutputBatch> &output, std::stop_token stop) {
+    while (auto batch{input.pop(stop)}) {
+        OutputBatch result{};
+        if (batch->error) {
+            result.error = batch->error;
+        } else {
+            try {
+                result.text.reserve(batch->text().size());
+                result.records = process_text(arguments, batch->text(), batch->firstLine, result.text);
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+        }
+
+        bool failed{static_cast<bool>(result.error)};
+        if (!output.push(std::move(result), stop) || failed)
+            break;
+    }
+
+    output.close();
+}
+
+// Returns the first failure, if any, after writing all batches before it.
+[[nodiscard]] inline std::exception_ptr write_batches(OutputQueues &queues, OutputWriter &output,
+                                                      std::stop_source &stop, std::size_t &records) noexcept {
+    try {
+        for (std::size_t sequence = 0;; ++sequence) {
+            auto batch{queues[sequence % queues.size()].pop(stop.get_token())};
+            if (!batch)
+                break;
+
+            if (batch->error) {
+                output.flush();
+                stop.request_stop();
+                return batch->error;
+            }
+
+            output.write(batch->text);
+            records += batch->records;
+        }
+
+        output.flush();
+        return nullptr;
+    } catch (...) {
+        stop.request_stop();
+        return std::current_exception();
+    }
+}
+
+[[nodiscard]] inline BatchStats run_pipeline(const Arguments &arguments, InputText &input, OutputWriter &output) {
+    verify_operand(arguments);
+    auto start{std::chrono::steady_clock::now()};
+
+    InputQueues inputQueues{};
+    OutputQueues outputQueues{};
+    for (std::size_t i = 0; i < arguments.threads; ++i) {
+        inputQueues.emplace_back(pipeline_queue_capacity);
+        outputQueues.emplace_back(pipeline_queue_capacity);
+    }
+
+    std::stop_source stop{};
+    BatchStats stats{};
+    std::exception_ptr error{};
+    std::vector<std::jthread> threads{};
+    threads.reserve(arguments.threads + 2);
+    try {
+        threads.emplace_back([&] { stats.bytes = BatchReader{input, inputQueues, stop.get_token()}(); });
+        for (std::size_t i = 0; i < arguments.threads; ++i) {
+            threads.emplace_back([&, i] {
+                process_batches(arguments, inputQueues[i], outputQueues[i], stop.get_token());
+            });
+        }
+
+        threads.emplace_back([&] { error = write_batches(outputQueues, output, stop, stats.records); });
+    } catch (...) {
+        // Otherwise the threads already started would wait for the missing ones forever.
+        stop.request_stop();
+        throw;
+    }
+
+    threads.clear();
+    if (error)
+        std::rethrow_exception(error);
+
+    stats.elapsed = std::chrono::steady_clock::now() - start;
+    return stats;
+}
+
+#endif
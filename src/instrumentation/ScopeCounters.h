@@ -0,0 +1,308 @@
+#ifndef CPPPLAYGROUND_SCOPECOUNTERS_H
+#define CPPPLAYGROUND_SCOPECOUNTERS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Hardware performance counters per scope of code, to tell why a kernel is
+ * slow, not just how long it takes.
+ *
+ * A ScopeCounters object reads the counters of the calling thread when it is
+ * created and again when it is destroyed, and adds the difference to the
+ * totals of its scope. The counters are opened once per thread as a single
+ * perf_event_open group, so that all of them cover exactly the same
+ * instructions. If they are not available, as is common in containers, only
+ * the time is measured, with the time stamp counter standing in for cycles.
+ * Scopes nest, and the counts of an outer scope include the inner ones.
+ *
+ * Every read is a system call, which is a lot compared to the small scopes
+ * it is wired into. Thus the instrumentation is only compiled in if
+ * CPPPLAYGROUND_INSTRUMENTATION is defined, see the CMake option of the same
+ * name. Then a summary of all scopes is written to stderr at exit.
+ */
+
+#ifdef CPPPLAYGROUND_INSTRUMENTATION
+inline constexpr bool instrumentation_enabled{true};
+#else
+inline constexpr bool instrumentation_enabled{false};
+#endif
+
+enum class Counter : std::size_t {
+    Cycles, Instructions, L1dMisses, LlcMisses, DtlbMisses, BranchMisses
+};
+
+inline constexpr std::size_t counter_count{6};
+
+[[nodiscard]] constexpr std::string_view to_string(Counter counter) noexcept {
+    constexpr std::array<std::string_view, counter_count> names{
+            "cycles", "instructions", "L1d misses", "LLC misses", "dTLB misses", "branch misses"};
+    return names[static_cast<std::size_t>(counter)];
+}
+
+struct CounterReading final {
+    std::array<std::uint64_t, counter_count> values{};
+    // Bit i is set if values[i] is valid.
+    unsigned valid{0};
+    std::uint64_t nanoseconds{0};
+};
+
+class PerfCounterGroup final {
+public:
+    PerfCounterGroup(const PerfCounterGroup &) = delete;
+    PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+    ~PerfCounterGroup() noexcept {
+        for (int fd : fds)
+            if (fd != -1)
+                close(fd);
+    }
+
+    [[nodiscard]] static PerfCounterGroup &forThisThread() noexcept {
+        thread_local PerfCounterGroup group{};
+        return group;
+    }
+
+    // Set if the hardware counters are not available and cycles come from the time stamp counter.
+    [[nodiscard]] bool usesTimeStampCounter() const noexcept {
+        return leader == -1;
+    }
+
+    [[nodiscard]] CounterReading read() const noexcept {
+        CounterReading reading{};
+        if (leader != -1) {
+            // PERF_FORMAT_GROUP: The number of events followed by their values.
+            std::array<std::uint64_t, 1 + counter_count> buffer{};
+            if (::read(leader, buffer.data(), sizeof(buffer)) > 0) {
+                std::size_t next{1};
+                for (std::size_t i = 0; i < counter_count; ++i) {
+                    if (fds[i] != -1 && next <= buffer[0]) {
+                        reading.values[i] = buffer[next++];
+                        reading.valid |= 1u << i;
+                    }
+                }
+            }
+        } else {
+#if defined(__x86_64__) || defined(__i386__)
+            reading.values[static_cast<std::size_t>(Counter::Cycles)] = __rdtsc();
+            reading.valid = 1u << static_cast<std::size_t>(Counter::Cycles);
+#endif
+        }
+
+        reading.nanoseconds = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count());
+        return reading;
+    }
+
+private:
+    PerfCounterGroup() noexcept {
+        constexpr auto cache_event {
+            [](std::uint64_t cache, std::uint64_t operation) {
+                return cache | (operation << 8) | (std::uint64_t{PERF_COUNT_HW_CACHE_RESULT_MISS} << 16);
+            }
+        };
+
+        constexpr std::array<std::pair<std::uint32_t, std::uint64_t>, counter_count> events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+
+        fds.fill(-1);
+        for (std::size_t i = 0; i < counter_count; ++i) {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.type = events[i].first;
+            attributes.config = events[i].second;
+            attributes.read_format = PERF_FORMAT_GROUP;
+            attributes.disabled = leader == -1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+
+            long fd{syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0)};
+            if (fd == -1) {
+                // Without cycles, the remaining counters are of little use.
+                if (i == 0)
+                    return;
+
+                continue;
+            }
+
+            fds[i] = static_cast<int>(fd);
+            if (leader == -1)
+                leader = fds[i];
+        }
+
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    std::array<int, counter_count> fds{};
+    int leader{-1};
+};
+
+struct ScopeStats final {
+    [[nodiscard]] explicit ScopeStats(std::string_view name) : name{name} {}
+
+    void add(const CounterReading &begin, const CounterReading &end) noexcept {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        nanoseconds.fetch_add(end.nanoseconds - begin.nanoseconds, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < counter_count; ++i) {
+            if ((begin.valid & end.valid & (1u << i)) != 0) {
+                totals[i].fetch_add(end.values[i] - begin.values[i], std::memory_order_relaxed);
+                samples[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::string name;
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+    std::array<std::atomic<std::uint64_t>, counter_count> totals{};
+    // Number of calls each counter was available for.
+    std::array<std::atomic<std::uint64_t>, counter_count> samples{};
+};
+
+class ScopeRegistry final {
+public:
+    ScopeRegistry(const ScopeRegistry &) = delete;
+    ScopeRegistry &operator=(const ScopeRegistry &) = delete;
+
+    ~ScopeRegistry() noexcept {
+        if (instrumentation_enabled && !scopes.empty())
+            report(stderr);
+    }
+
+    [[nodiscard]] static ScopeRegistry &instance() {
+        static ScopeRegistry registry{};
+        return registry;
+    }
+
+    // References stay valid for the lifetime of the registry.
+    [[nodiscard]] ScopeStats &add(std::string_view name) {
+        std::scoped_lock lock{mutex};
+        return scopes.emplace_back(name);
+    }
+
+    // One line per scope with the average per call.
+    void report(std::FILE *out) const noexcept {
+        std::scoped_lock lock{mutex};
+        std::fprintf(out, "%-32s %12s %12s", "scope", "calls", "ns/call");
+        for (std::size_t i = 0; i < counter_count; ++i)
+            std::fprintf(out, " %14s", std::string{to_string(static_cast<Counter>(i))}.c_str());
+
+        std::fprintf(out, "\n");
+        bool timeStampCounter{false};
+        for (const auto &scope : scopes) {
+            std::uint64_t calls{scope.calls.load(std::memory_order_relaxed)};
+            if (calls == 0)
+                continue;
+
+            std::fprintf(out, "%-32s %12llu %12.1f", scope.name.c_str(), static_cast<unsigned long long>(calls),
+                         static_cast<double>(scope.nanoseconds.load(std::memory_order_relaxed)) / static_cast<double>(calls));
+            for (std::size_t i = 0; i < counter_count; ++i) {
+                std::uint64_t samples{scope.samples[i].load(std::memory_order_relaxed)};
+                if (samples == 0) {
+                    std::fprintf(out, " %14s", "-");
+                } else {
+                    std::fprintf(out, " %14.1f", static_cast<double>(scope.totals[i].load(std::memory_order_relaxed))
+                                                 / static_cast<double>(samples));
+                }
+            }
+
+            std::fprintf(out, "\n");
+            timeStampCounter |= scope.samples[static_cast<std::size_t>(Counter::Instructions)] == 0
+                                && scope.samples[static_cast<std::size_t>(Counter::Cycles)] != 0;
+        }
+
+        if (timeStampCounter)
+            std::fprintf(out, "Hardware counters unavailable, cycles are time stamp counter ticks.\n");
+    }
+
+private:
+    ScopeRegistry() = default;
+
+    mutable std::mutex mutex{};
+    std::deque<ScopeStats> scopes{};
+};
+
+// String literal usable as template argument, so that each scope name gets its own statistics.
+template<std::size_t N>
+struct ScopeName final {
+    [[nodiscard]] consteval ScopeName(const char (&name)[N]) noexcept {
+        std::copy_n(name, N, value);
+    }
+
+    [[nodiscard]] constexpr std::string_view view() const noexcept {
+        return {value, N - 1};
+    }
+
+    char value[N];
+};
+
+template<ScopeName Name>
+[[nodiscard]] ScopeStats &scope_stats() {
+    static ScopeStats &stats{ScopeRegistry::instance().add(Name.view())};
+    return stats;
+}
+
+/*
+ * Literal type, so that it may be used in constexpr functions. It does nothing
+ * during constant evaluation.
+ */
+template<ScopeName Name>
+class ScopeCounters final {
+public:
+    [[nodiscard]] constexpr ScopeCounters() noexcept {
+        if (!std::is_constant_evaluated())
+            begin = PerfCounterGroup::forThisThread().read();
+    }
+
+    ScopeCounters(const ScopeCounters &) = delete;
+    ScopeCounters &operator=(const ScopeCounters &) = delete;
+
+    constexpr ~ScopeCounters() noexcept {
+        if (!std::is_constant_evaluated()) {
+            CounterReading end{PerfCounterGroup::forThisThread().read()};
+            scope_stats<Name>().add(begin, end);
+        }
+    }
+
+private:
+    CounterReading begin{};
+};
+
+#define CPPPLAYGROUND_CONCAT_IMPL(a, b) a##b
+#define CPPPLAYGROUND_CONCAT(a, b) CPPPLAYGROUND_CONCAT_IMPL(a, b)
+
+#ifdef CPPPLAYGROUND_INSTRUMENTATION
+#define CPPPLAYGROUND_SCOPE_COUNTERS(name) \
+    const ScopeCounters<name> CPPPLAYGROUND_CONCAT(scopeCounters, __LINE__){}
+#else
+#define CPPPLAYGROUND_SCOPE_COUNTERS(name) static_cast<void>(0)
+#endif
+
+#endif
@@ -1,11 +1,20 @@
+#include<cstdlib>
+#include<exception>
+#include<iostream>
 #include<ranges>
+#include<stdexcept>
 #include<string_view>
 
 #include "ExitCode.h"
+#include "cli/Arguments.h"
+#include "cli/CliErrors.h"
+#include "cli/InputText.h"
+#include "cli/OutputWriter.h"
+#include "cli/Pipeline.h"
 
 template<std::ranges::random_access_range R>
     requires std::same_as<std::ranges::range_value_t<R>, std::string_view>
-[[nodiscard]] std::uint8_t newMain([[maybe_unused]] R args) noexcept;
+[[nodiscard]] std::uint8_t newMain(R args) noexcept;
 
 int main(const int argc, char const * const * const argv) {
     auto toStringView = [](auto s) {return std::string_view{s};};
@@ -15,10 +24,47 @@ int main(const int argc, char const * const * const argv) {
 }
 
 
-enum class ExitCodes : ExitCode_t {Success = EXIT_SUCCESS, Failure = EXIT_FAILURE};
+enum class ExitCodes : ExitCode_t {
+    Success = EXIT_SUCCESS,
+    Failure = EXIT_FAILURE,
+    UsageError = 2,
+    InputError = 3,
+    OutputError = 4,
+    ParseError = 5,
+    InvalidOpinion = 6
+};
 
 template<std::ranges::random_access_range R>
     requires std::same_as<std::ranges::range_value_t<R>, std::string_view>
-[[nodiscard]] std::uint8_t newMain([[maybe_unused]] R args) noexcept {
-    return *ExitCode(ExitCodes::Success);
-}
\ No newline at end of file
+[[nodiscard]] std::uint8_t newMain(R args) noexcept {
+    try {
+        Arguments arguments{parse_arguments(args | std::views::drop(1))};
+        InputText input{arguments.input};
+        OutputWriter output{arguments.output};
+        BatchStats stats{run_pipeline(arguments, input, output)};
+        if (arguments.stats)
+            std::cerr << stats << '\n';
+
+        return *ExitCode(ExitCodes::Success);
+    } catch (const UsageError &e) {
+        std::cerr << e.what() << "\n\n" << usage;
+        return *ExitCode(ExitCodes::UsageError);
+    } catch (const InputError &e) {
+        std::cerr << e.what() << '\n';
+        return *ExitCode(ExitCodes::InputError);
+    } catch (const OutputError &e) {
+        std::cerr << e.what() << '\n';
+        return *ExitCode(ExitCodes::OutputError);
+    } catch (const ParseError &e) {
+        std::cerr << e.what() << '\n';
+        return *ExitCode(ExitCodes::ParseError);
+    } catch (const InvalidRecordError &e) {
+        std::cerr << e.what() << '\n';
+        return *ExitCode(ExitCodes::InvalidOpinion);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return *ExitCode(ExitCodes::Failure);
+    } catch (...) {
+        return *ExitCode(ExitCodes::Failure);
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef CPPPLAYGROUND_SPSCQUEUE_H
+#define CPPPLAYGROUND_SPSCQUEUE_H
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Bounded lock-free queue for exactly one producer and one consumer thread.
+ * The producer only ever writes head and the consumer only ever writes tail,
+ * so both sides get along with plain loads and stores. Each side keeps a
+ * cached copy of the index of the other side and only reloads it when the
+ * queue looks full or empty, which keeps the two cache lines from bouncing
+ * between the cores on every operation.
+ *
+ * The blocking push() and pop() back off from spinning to sleeping and give
+ * up once stop is requested, so a full queue applies backpressure to the
+ * producer without ever blocking on a lock.
+ */
+template<typename T>
+    requires std::default_initializable<T> && std::movable<T>
+class SpscQueue final {
+public:
+    [[nodiscard]] explicit SpscQueue(std::size_t capacity)
+        : slots(std::bit_ceil(capacity)), mask{slots.size() - 1} {
+        if (capacity == 0)
+            throw std::invalid_argument("Capacity must not be zero.");
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return slots.size();
+    }
+
+    // Producer only. Leaves value untouched if the queue is full.
+    [[nodiscard]] bool tryPush(T &value) {
+        const std::size_t currentHead{head.load(std::memory_order_relaxed)};
+        if (currentHead - producerCachedTail == slots.size()) {
+            producerCachedTail = tail.load(std::memory_order_acquire);
+            if (currentHead - producerCachedTail == slots.size())
+                return false;
+        }
+
+        slots[currentHead & mask] = std::move(value);
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    [[nodiscard]] std::optional<T> tryPop() {
+        const std::size_t currentTail{tail.load(std::memory_order_relaxed)};
+        if (currentTail == consumerCachedHead) {
+            consumerCachedHead = head.load(std::memory_order_acquire);
+            if (currentTail == consumerCachedHead)
+                return std::nullopt;
+        }
+
+        std::optional<T> value{std::move(slots[currentTail & mask])};
+        tail.store(currentTail + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Producer only. Blocks while the queue is full. Returns false if stop was
+    // requested before the value could be pushed.
+    [[nodiscard]] bool push(T value, std::stop_token stop) {
+        for (Backoff backoff{}; !tryPush(value); backoff.wait()) {
+            if (stop.stop_requested())
+                return false;
+        }
+
+        return true;
+    }
+
+    // Consumer only. Blocks while the queue is empty. Returns std::nullopt if
+    // the queue was closed and is drained, or if stop was requested.
+    [[nodiscard]] std::optional<T> pop(std::stop_token stop) {
+        for (Backoff backoff{};; backoff.wait()) {
+            // Check closed before trying to pop, otherwise the last values
+            // could be pushed in between and lost.
+            bool wasClosed{closed.load(std::memory_order_acquire)};
+            if (auto value{tryPop()})
+                return value;
+
+            if (wasClosed || stop.stop_requested())
+                return std::nullopt;
+        }
+    }
+
+    // Producer only. No more values will be pushed.
+    void close() noexcept {
+        closed.store(true, std::memory_order_release);
+    }
+
+private:
+    class Backoff final {
+    public:
+        void wait() noexcept {
+            if (rounds < spinRounds) {
+                ++rounds;
+            } else if (rounds < spinRounds + yieldRounds) {
+                ++rounds;
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds{50});
+            }
+        }
+
+    private:
+        static constexpr int spinRounds{64};
+        static constexpr int yieldRounds{64};
+        int rounds{0};
+    };
+
+    static constexpr std::size_t cacheLineSize{64};
+
+    std::vector<T> slots;
+    std::size_t mask;
+
+    alignas(cacheLineSize) std::atomic<std::size_t> head{0};
+    std::size_t producerCachedTail{0};
+
+    alignas(cacheLineSize) std::atomic<std::size_t> tail{0};
+    std::size_t consumerCachedHead{0};
+
+    alignas(cacheLineSize) std::atomic<bool> closed{false};
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef CPPPLAYGROUND_THREADPOOL_H
+#define CPPPLAYGROUND_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Thread pool with one task queue per worker and work stealing.
+ *
+ * A worker takes the newest task from its own queue, which is likely still in
+ * its cache, and only if that is empty steals the oldest task from another
+ * queue. Tasks submitted from outside the pool are spread round robin.
+ *
+ * parallelFor() blocks until all chunks are done, but the calling thread
+ * helps to run tasks in the meantime. Thus it may also be called from within
+ * a task without deadlocking the pool.
+ */
+class ThreadPool final {
+public:
+    [[nodiscard]] explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : queues(std::max<std::size_t>(threads, 1)) {
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            workers.emplace_back([this, i](std::stop_token stop) { work(stop, i); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Waits for the running tasks, but drops the ones still queued. The
+    // workers are declared last, so they are stopped and joined first.
+    ~ThreadPool() noexcept = default;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return workers.size();
+    }
+
+    // The task must not throw. If submit throws, the task was not queued.
+    void submit(std::function<void()> task) {
+        std::size_t index{current_pool == this ? current_worker : nextQueue++ % queues.size()};
+        {
+            // Both locks are taken up front, so nothing can throw once the task is published.
+            std::scoped_lock lock{queues[index].mutex, sleepMutex};
+            queues[index].tasks.push_back(std::move(task));
+            queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+
+    /*
+     * Calls fn(begin, end) for consecutive chunks of at most grain elements of
+     * [0, count), in parallel. If any call throws, the exception of the first
+     * failing chunk is rethrown once all chunks are done.
+     */
+    template<typename Fn>
+    void parallelFor(std::size_t count, std::size_t grain, Fn &&fn) {
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t chunks{(count + grain - 1) / grain};
+        if (chunks == 0)
+            return;
+
+        // Shared, as the last task still notifies after the caller may already see zero.
+        auto state{std::make_shared<ParallelForState>(chunks)};
+        auto runChunk {
+            [state, &fn, count, grain](std::size_t chunk) noexcept {
+                std::size_t begin{chunk * grain};
+                try {
+                    fn(begin, std::min(begin + grain, count));
+                } catch (...) {
+                    std::scoped_lock lock{state->errorMutex};
+                    if (chunk < state->errorChunk) {
+                        state->errorChunk = chunk;
+                        state->error = std::current_exception();
+                    }
+                }
+
+                if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    state->remaining.notify_all();
+            }
+        };
+
+        // The caller takes the first chunk itself. If queueing fails, the chunks
+        // already queued still refer to fn, so they are waited for before rethrowing.
+        std::size_t submitted{1};
+        std::exception_ptr submitError{};
+        try {
+            for (; submitted < chunks; ++submitted)
+                submit([runChunk, chunk = submitted] { runChunk(chunk); });
+        } catch (...) {
+            submitError = std::current_exception();
+        }
+
+        if (submitError)
+            state->remaining.fetch_sub(chunks - submitted + 1, std::memory_order_acq_rel);
+        else
+            runChunk(0);
+
+        for (std::size_t remaining; (remaining = state->remaining.load(std::memory_order_acquire)) != 0;) {
+            if (!tryRunOne(current_pool == this ? current_worker : 0))
+                state->remaining.wait(remaining, std::memory_order_acquire);
+        }
+
+        if (submitError)
+            std::rethrow_exception(submitError);
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+
+private:
+    struct alignas(64) WorkerQueue final {
+        std::mutex mutex{};
+        std::deque<std::function<void()>> tasks{};
+    };
+
+    struct ParallelForState final {
+        [[nodiscard]] explicit ParallelForState(std::size_t chunks) noexcept : remaining{chunks} {}
+
+        std::atomic<std::size_t> remaining;
+        std::mutex errorMutex{};
+        std::size_t errorChunk{std::numeric_limits<std::size_t>::max()};
+        std::exception_ptr error{};
+    };
+
+    [[nodiscard]] std::optional<std::function<void()>> take(std::size_t index, bool newest) {
+        auto &queue{queues[index]};
+        std::scoped_lock lock{queue.mutex};
+        if (queue.tasks.empty())
+            return std::nullopt;
+
+        std::function<void()> task;
+        if (newest) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    // Runs a task of the own queue or steals one. Returns false if all queues are empty.
+    bool tryRunOne(std::size_t own) {
+        auto task{take(own, true)};
+        for (std::size_t i = 1; !task && i < queues.size(); ++i)
+            task = take((own + i) % queues.size(), false);
+
+        if (!task)
+            return false;
+
+        (*task)();
+        return true;
+    }
+
+    void work(std::stop_token stop, std::size_t index) {
+        current_pool = this;
+        current_worker = index;
+        while (!stop.stop_requested()) {
+            if (tryRunOne(index))
+                continue;
+
+            std::unique_lock lock{sleepMutex};
+            wake.wait(lock, stop, [this] { return queued.load(std::memory_order_relaxed) > 0; });
+        }
+    }
+
+    static inline thread_local const ThreadPool *current_pool{nullptr};
+    static inline thread_local std::size_t current_worker{0};
+
+    std::deque<WorkerQueue> queues;
+    std::atomic<std::size_t> nextQueue{0};
+    // Only a hint for sleeping workers, it may briefly drop below zero.
+    std::atomic<std::ptrdiff_t> queued{0};
+    std::mutex sleepMutex{};
+    std::condition_variable_any wake{};
+    std::vector<std::jthread> workers{};
+};
+
+// Shared pool with one worker per hardware thread, created on first use.
+[[nodiscard]] inline ThreadPool &default_thread_pool() {
+    static ThreadPool pool{};
+    return pool;
+}
+
+#endif
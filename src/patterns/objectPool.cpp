@@ -4,6 +4,8 @@
 #include <ranges>
 #include <vector>
 
+#include "../instrumentation/ScopeCounters.h"
+
 #define NDEBUG
 
 template<typename T, typename A = std::allocator<T>>
@@ -122,6 +124,7 @@ public:
 
     template<typename... Args>
     [[nodiscard]] constexpr T& claim(Args &&...args) {
+        CPPPLAYGROUND_SCOPE_COUNTERS("ObjectPool::claim");
         if (freeCount() == 0) {
             throw std::runtime_error("No free objects available.");
         }
@@ -135,6 +138,7 @@ public:
     }
 
     constexpr void reclaim(T &value) {
+        CPPPLAYGROUND_SCOPE_COUNTERS("ObjectPool::reclaim");
         if (usedCount() == 0) {
             throw std::logic_error("Cannot reclaim a value if no value is in use.");
         }
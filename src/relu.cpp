@@ -1,8 +1,7 @@
-#include<type_traits>
-#include<bit>
-#include<cmath>
 #include <iostream>
 
+#include "activation/relu.h"
+
 /*
  * Test: Can Relu be implemented more efficiently than just using std::max by
  * making use of  bit twiddling?
@@ -28,24 +27,6 @@
  * Compilers really do some magical stuff.
  */
 
-template<typename T>
-concept plain_signed = std::is_signed_v<T> && (!std::is_const_v<T>)
-                                           && (!std::is_volatile_v<T>);
-
-template<plain_signed T>
-[[nodiscard]]constexpr T relu_using_max(T n) noexcept {
-    return std::max<T>(n, T(0));
-}
-
-template<plain_signed T>
-[[nodiscard]]constexpr T relu_bit_twiddle(T n) noexcept {
-    using U = std::make_unsigned_t<T>;
-    U n_unsigned {std::bit_cast<U, T>(n)};
-    bool is_negative {std::signbit(n)};
-    U mask {U(0) - U(!is_negative)};
-    return n_unsigned & mask;
-}
-
 int main() {
     auto is_correct {
         [](plain_signed auto x) -> bool {
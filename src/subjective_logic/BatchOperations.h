@@ -0,0 +1,119 @@
+#ifndef CPPPLAYGROUND_BATCHOPERATIONS_H
+#define CPPPLAYGROUND_BATCHOPERATIONS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "BinomialOpinion.h"
+#include "MultinomialOpinion.h"
+#include "Operations.h"
+#include "Validation.h"
+#include "../patterns/ThreadPool.h"
+
+/*
+ * Operations on whole arrays of opinions, run in parallel on a thread pool.
+ *
+ * The input is split into chunks whose input and output together fit into
+ * a typical L2 cache, but into at least a few chunks per thread, so that
+ * work stealing can even out slow ones. The results are written into
+ * preallocated output spans of the same size as the input, element i of the
+ * output belonging to element i of the input. If an operation throws, the
+ * exception of the first failing chunk is rethrown after all chunks are done
+ * and the output is partially written.
+ */
+
+inline constexpr std::size_t batch_chunk_bytes{256 * 1024};
+
+// Elements per chunk. For dynamic opinions, only the inline part counts, not their heap buffer.
+template<typename In, typename Out>
+[[nodiscard]] std::size_t batch_grain(std::size_t count, const ThreadPool &pool) noexcept {
+    const std::size_t fitting{std::max<std::size_t>(batch_chunk_bytes / (sizeof(In) + sizeof(Out)), 1)};
+    const std::size_t chunks{4 * (pool.size() + 1)};
+    return std::clamp<std::size_t>((count + chunks - 1) / chunks, 1, fitting);
+}
+
+template<typename In, typename Out, typename Fn>
+void transform_batch(std::span<const In> in, std::span<Out> out, ThreadPool &pool, Fn fn) {
+    if (in.size() != out.size())
+        throw std::invalid_argument("Input and output must be of the same size.");
+
+    pool.parallelFor(in.size(), batch_grain<In, Out>(in.size(), pool), [in, out, &fn](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = fn(in[i]);
+    });
+}
+
+template<plain_floating_point F, std::size_t N>
+void coarsen_batch(std::span<const MultinomialOpinion<F, N>> in, std::size_t to, std::span<BinomialOpinion<F>> out,
+                   ThreadPool &pool = default_thread_pool()) {
+    if constexpr (N != std::dynamic_extent) {
+        if (to >= N)
+            throw std::invalid_argument("Cannot coarsen to argument that is out of range.");
+
+        transform_batch(in, out, pool, [to](const MultinomialOpinion<F, N> &opinion) noexcept {
+            return coarsen_unsafe<F, N, true>(opinion, to);
+        });
+    } else {
+        transform_batch(in, out, pool, [to](const MultinomialOpinion<F, N> &opinion) {
+            return coarsen(opinion, to);
+        });
+    }
+}
+
+template<plain_floating_point F, std::size_t N>
+    requires (N != std::dynamic_extent)
+void make_static_batch(std::span<const MultinomialOpinion<F, std::dynamic_extent>> in,
+                       std::span<MultinomialOpinion<F, N>> out, ThreadPool &pool = default_thread_pool()) {
+    transform_batch(in, out, pool, [](const MultinomialOpinion<F, std::dynamic_extent> &opinion) {
+        return make_static<F, N>(opinion);
+    });
+}
+
+template<plain_floating_point F, std::size_t N>
+    requires (N != std::dynamic_extent)
+void make_dynamic_batch(std::span<const MultinomialOpinion<F, N>> in,
+                        std::span<MultinomialOpinion<F, std::dynamic_extent>> out, ThreadPool &pool = default_thread_pool()) {
+    transform_batch(in, out, pool, [](const MultinomialOpinion<F, N> &opinion) {
+        return make_dynamic(opinion);
+    });
+}
+
+/*
+ * Same result as find_invalid_opinions(). The chunks are counted in parallel,
+ * then only the few chunks with invalid opinions are searched again to write
+ * their indices in order.
+ */
+template<validatable_opinion Opinion>
+[[nodiscard]] std::size_t find_invalid_opinions_batch(std::span<const Opinion> opinions, std::span<std::size_t> invalid,
+                                                      ThreadPool &pool = default_thread_pool()) {
+    const std::size_t grain{batch_grain<Opinion, std::size_t>(opinions.size(), pool)};
+    std::vector<std::size_t> counts((opinions.size() + grain - 1) / grain);
+    pool.parallelFor(opinions.size(), grain, [opinions, grain, &counts](std::size_t begin, std::size_t end) {
+        counts[begin / grain] = find_invalid_opinions(opinions.subspan(begin, end - begin), std::span<std::size_t>{});
+    });
+
+    std::size_t count{0};
+    for (std::size_t chunk = 0; chunk < counts.size(); ++chunk) {
+        if (counts[chunk] != 0 && count < invalid.size()) {
+            std::size_t begin{chunk * grain};
+            auto indices{invalid.subspan(count, std::min(counts[chunk], invalid.size() - count))};
+            static_cast<void>(find_invalid_opinions(opinions.subspan(begin, std::min(grain, opinions.size() - begin)), indices));
+            for (std::size_t &index : indices)
+                index += begin;
+        }
+
+        count += counts[chunk];
+    }
+
+    return count;
+}
+
+template<validatable_opinion Opinion>
+[[nodiscard]] bool all_valid_batch(std::span<const Opinion> opinions, ThreadPool &pool = default_thread_pool()) {
+    return find_invalid_opinions_batch(opinions, std::span<std::size_t>{}, pool) == 0;
+}
+
+#endif
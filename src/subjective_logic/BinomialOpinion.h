@@ -1,20 +1,28 @@
 #ifndef CPPPLAYGROUND_BINOMIALOPINION_H
 #define CPPPLAYGROUND_BINOMIALOPINION_H
 
+#include <algorithm>
+#include <array>
 #include <ostream>
 #include <stdexcept>
 
 #include "floatingPointHelper.h"
+#include "Unchecked.h"
+#include "../instrumentation/ScopeCounters.h"
 
 template<plain_floating_point F>
 class BinomialOpinion final {
 public:
     [[nodiscard]] constexpr BinomialOpinion(F belief, F disbelief, F uncertainty, F apriori)
         : belief{belief}, disbelief{disbelief}, uncertainty{uncertainty}, apriori{apriori} {
+        CPPPLAYGROUND_SCOPE_COUNTERS("BinomialOpinion()");
         if (!verifySelf())
             throw std::invalid_argument{"Binomial opinion is invalid."};
     }
 
+    [[nodiscard]] constexpr BinomialOpinion(unchecked_t, F belief, F disbelief, F uncertainty, F apriori) noexcept
+        : belief{belief}, disbelief{disbelief}, uncertainty{uncertainty}, apriori{apriori} {}
+
     [[nodiscard]] constexpr F getBelief() const noexcept {
         return belief;
     }
@@ -31,12 +39,22 @@ public:
         return apriori;
     }
 
+    // True for opinions from the checked constructor and from coarsen(). Opinions
+    // created using the unchecked constructor from other values may be invalid.
+    [[nodiscard]] constexpr bool isValid() const noexcept {
+        return verifySelf();
+    }
+
 private:
+    // Without branches, so that find_invalid_opinions() can be vectorised.
     [[nodiscard]] constexpr bool verifySelf() const noexcept {
         std::array components{belief, disbelief, uncertainty, apriori};
-        auto all_between_zero_and_one{std::ranges::all_of(components, is_between_zero_and_one_inclusive<F>)};
+        bool all_between_zero_and_one{true};
+        for (F component : components)
+            all_between_zero_and_one &= is_between_zero_and_one_inclusive(component);
+
         auto sum{belief + disbelief + uncertainty};
-        return all_between_zero_and_one && is_approx_one(sum);
+        return all_between_zero_and_one & is_approx_one(sum);
     }
 
 private:
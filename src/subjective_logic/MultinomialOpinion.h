@@ -11,7 +11,9 @@
 #include <stdexcept>
 
 #include "floatingPointHelper.h"
+#include "Unchecked.h"
 #include "../FlexArray.h"
+#include "../instrumentation/ScopeCounters.h"
 
 template<plain_floating_point F, std::size_t Size>
 requires (Size >= 2)
@@ -23,6 +25,7 @@ public:
     [[nodiscard]] constexpr MultinomialOpinion(const R1 beliefs, F uncertainty, const R2 apriories)
             : beliefsAndApriories{make_FlexArray<F, ArraySize>(std::ranges::size(beliefs) * 2)},
               uncertainty{uncertainty}  {
+        CPPPLAYGROUND_SCOPE_COUNTERS("MultinomialOpinion()");
         if (std::ranges::size(beliefs) != std::ranges::size(apriories))
             throw std::invalid_argument("Number of beliefs and number of apriories must be equal.");
 
@@ -38,6 +41,18 @@ public:
             throw std::invalid_argument("Invariant for multinomial opinion does not hold.");
     }
 
+    // Requires beliefs and apriories of the same size, which must be at least 2.
+    template<std::ranges::input_range R1, std::ranges::input_range R2>
+        requires std::ranges::view<R1> && std::ranges::sized_range<R1> && std::same_as<std::remove_cv_t<std::ranges::range_value_t<R1>>, F>
+              && std::ranges::view<R2> && std::ranges::sized_range<R2> && std::same_as<std::remove_cv_t<std::ranges::range_value_t<R2>>, F>
+    [[nodiscard]] constexpr MultinomialOpinion(unchecked_t, const R1 beliefs, F uncertainty, const R2 apriories)
+            : beliefsAndApriories{make_FlexArray<F, ArraySize>(std::ranges::size(beliefs) * 2)},
+              uncertainty{uncertainty}  {
+        auto buffer {beliefsAndApriories.getMut()};
+        std::ranges::copy(beliefs, std::begin(buffer));
+        std::ranges::copy(apriories, std::next(std::begin(buffer), std::ranges::size(beliefs)));
+    }
+
     [[nodiscard]] constexpr std::span<const F, Size>  getBeliefs() const noexcept {
         return getComponent<Component::Beliefs>();
     }
@@ -50,6 +65,13 @@ public:
         return uncertainty;
     }
 
+    // True for opinions from the checked constructor and from the conversions in
+    // Operations.h. Opinions created using the unchecked constructor from other
+    // values may be invalid.
+    [[nodiscard]] constexpr bool isValid() const noexcept {
+        return verifySelf();
+    }
+
     [[nodiscard]] inline constexpr bool is_dynamic_sized() const noexcept {
         return Size == std::dynamic_extent;
     }
@@ -80,24 +102,19 @@ private:
         }
     }
 
+    // Without early exits or branches, so that the compiler can vectorise it.
     [[nodiscard]] constexpr bool verifySelf() const noexcept {
-        bool in_range{is_between_zero_and_one_inclusive(uncertainty)
-                && std::ranges::all_of(beliefsAndApriories.get(),
-                                       is_between_zero_and_one_inclusive<F>)};
-        if(!in_range)
-            return false;
+        bool in_range{is_between_zero_and_one_inclusive(uncertainty)};
+        for (F x : beliefsAndApriories.get())
+            in_range &= is_between_zero_and_one_inclusive(x);
 
         auto beliefs{getBeliefs()};
-        F belief_sum{std::accumulate(std::begin(beliefs), std::end(beliefs), 0.0)};
-        if(!is_approx_one(belief_sum + uncertainty))
-            return false;
+        F belief_sum{std::accumulate(std::begin(beliefs), std::end(beliefs), F(0))};
 
         auto apriories{getApriories()};
-        F apriories_sum{std::accumulate(std::begin(apriories), std::end(apriories), 0.0)};
-        if(!is_approx_one(apriories_sum))
-            return false;
+        F apriories_sum{std::accumulate(std::begin(apriories), std::end(apriories), F(0))};
 
-        return true;
+        return in_range & is_approx_one(belief_sum + uncertainty, size() + 1) & is_approx_one(apriories_sum, size());
     }
 
     static inline constexpr std::size_t ArraySize
@@ -111,20 +128,22 @@ template<plain_floating_point F, std::size_t Size>
 constexpr std::ostream& operator<<(std::ostream &os, const MultinomialOpinion<F, Size>& opinion) {
 
     auto printSpan {
-            [&os](std::span<F, Size> s){
+            [&os](std::span<const F, Size> s) {
                 auto printElement {[&os](F x) { os << x << ", "; }};
                 os << "[";
                 std::for_each_n(std::begin(s), s.size() - 1, printElement);
-                return (os << s.last() << "]");
+                os << s.back() << "]";
             }
     };
 
-    return (os << "MultinomialOpinion{size: " << opinion.size()
-               << ", isDynamicSized: " << opinion.is_dynamic_sized()
-               << ", beliefs: " << printSpan(opinion.getBeliefs())
-               << ", uncertainty: " << opinion.getUncertainty()
-               << ", apriories: " << printSpan(opinion.getApriories())
-               << "}");
+    os << "MultinomialOpinion{size: " << opinion.size()
+       << ", isDynamicSized: " << opinion.is_dynamic_sized()
+       << ", beliefs: ";
+    printSpan(opinion.getBeliefs());
+    os << ", uncertainty: " << opinion.getUncertainty()
+       << ", apriories: ";
+    printSpan(opinion.getApriories());
+    return (os << "}");
 }
 
 #endif
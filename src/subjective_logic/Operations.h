@@ -1,17 +1,22 @@
 #ifndef CPPPLAYGROUND_OPERATIONS_H
 #define CPPPLAYGROUND_OPERATIONS_H
 
+#include <algorithm>
 #include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "floatingPointHelper.h"
 #include "MultinomialOpinion.h"
 #include "BinomialOpinion.h"
+#include "SparseMultinomialOpinion.h"
 
 
 template<plain_floating_point F, std::size_t N>
     requires (N != std::dynamic_extent)
 [[nodiscard]] constexpr MultinomialOpinion<F, std::dynamic_extent> make_dynamic(const MultinomialOpinion<F, N>& multinomialOpinion) {
-    return MultinomialOpinion<F, std::dynamic_extent>{multinomialOpinion.getBeliefs(), multinomialOpinion.getUncertainty(), multinomialOpinion.getApriories()};
+    return MultinomialOpinion<F, std::dynamic_extent>{unchecked, multinomialOpinion.getBeliefs(), multinomialOpinion.getUncertainty(), multinomialOpinion.getApriories()};
 }
 
 template<plain_floating_point F, std::size_t N>
@@ -21,25 +26,28 @@ template<plain_floating_point F, std::size_t N>
         throw std::invalid_argument("Static and dynamic size do not match.");
     }
 
-    return MultinomialOpinion<F, N>{multinomialOpinion.getBeliefs(), multinomialOpinion.getUncertainty(), multinomialOpinion.getApriories()};
+    return MultinomialOpinion<F, N>{unchecked, multinomialOpinion.getBeliefs(), multinomialOpinion.getUncertainty(), multinomialOpinion.getApriories()};
 }
 
 template<plain_floating_point F, std::size_t N, bool IsNoexcept = false>
 [[nodiscard]] constexpr BinomialOpinion<F> coarsen_unsafe(const MultinomialOpinion<F, N>& multinomialOpinion, std::size_t to) noexcept(IsNoexcept) {
-    F belief {multinomialOpinion.getBeliefs().at(to)};
     F uncertainty {multinomialOpinion.getUncertainty()};
-    F disbelief {1.0 - belief - uncertainty};
-    F apriori {multinomialOpinion.getApriories().at(to)};
-    return BinomialOpinion<F>{belief, disbelief, uncertainty, apriori};
+    // The sum of a multinomial opinion may exceed one by epsilon per category,
+    // the binomial one only by epsilon. Clamping the belief keeps it valid.
+    F belief {std::min(multinomialOpinion.getBeliefs()[to], F(1.0) - uncertainty)};
+    // Clamped, as rounding may push the difference slightly below zero.
+    F disbelief {std::max(F(0.0), F(1.0) - belief - uncertainty)};
+    F apriori {multinomialOpinion.getApriories()[to]};
+    return BinomialOpinion<F>{unchecked, belief, disbelief, uncertainty, apriori};
 }
 
 template<plain_floating_point F, std::size_t N>
 [[nodiscard]] constexpr BinomialOpinion<F> coarsen(const MultinomialOpinion<F, N>& multinomialOpinion, std::size_t to) {
-    if(multinomialOpinion.size() >= to) {
+    if(to >= multinomialOpinion.size()) {
         throw std::invalid_argument("Cannot coarsen to argument that is out of range.");
     }
 
-    return coarsen_unsafe<F, N, true>(multinomialOpinion, to);
+    return coarsen_unsafe<F, N>(multinomialOpinion, to);
 }
 
 
@@ -49,4 +57,119 @@ requires ((N != std::dynamic_extent) && (TO < N)) || (TO < 2)
     return coarsen_unsafe<F, N, true>(multinomialOpinion, TO);
 }
 
+// Runs in O(log nonZeroCount()).
+template<plain_floating_point F>
+[[nodiscard]] BinomialOpinion<F> coarsen(const SparseMultinomialOpinion<F> &opinion, std::size_t to) {
+    if(to >= opinion.size()) {
+        throw std::invalid_argument("Cannot coarsen to argument that is out of range.");
+    }
+
+    F uncertainty {opinion.getUncertainty()};
+    // Clamped like in coarsen_unsafe(), as the sparse sum has a larger tolerance, too.
+    F belief {std::min(opinion.getBelief(to), F(1.0) - uncertainty)};
+    F disbelief {std::max(F(0.0), F(1.0) - belief - uncertainty)};
+    return BinomialOpinion<F>{unchecked, belief, disbelief, uncertainty, opinion.getApriori(to)};
+}
+
+// Dense opinions store every category, so the conversions necessarily run in
+// the size of the domain.
+template<plain_floating_point F>
+[[nodiscard]] MultinomialOpinion<F, std::dynamic_extent> make_dense(const SparseMultinomialOpinion<F> &opinion) {
+    std::vector<F> beliefs(opinion.size(), F(0));
+    for (const auto &[index, mass] : opinion.getBeliefs())
+        beliefs[index] = mass;
+
+    std::vector<F> apriories(opinion.size());
+    for (std::size_t i = 0; i < apriories.size(); ++i)
+        apriories[i] = opinion.getApriori(i);
+
+    // Checked, as the apriories are computed from the base rates rather than copied.
+    return MultinomialOpinion<F, std::dynamic_extent>{std::span<const F>{beliefs}, opinion.getUncertainty(),
+                                                      std::span<const F>{apriories}};
+}
+
+template<plain_floating_point F, std::size_t N>
+[[nodiscard]] std::vector<SparseBelief<F>> sparse_beliefs(const MultinomialOpinion<F, N> &opinion) {
+    std::vector<SparseBelief<F>> beliefs{};
+    auto dense{opinion.getBeliefs()};
+    for (std::size_t i = 0; i < dense.size(); ++i)
+        if (dense[i] != F(0))
+            beliefs.push_back({i, dense[i]});
+
+    return beliefs;
+}
+
+// Shares the given base rates, which must equal the apriories of the opinion.
+template<plain_floating_point F, std::size_t N>
+[[nodiscard]] SparseMultinomialOpinion<F> make_sparse(const MultinomialOpinion<F, N> &opinion, BaseRates<F> baseRates) {
+    auto apriories{opinion.getApriories()};
+    if (baseRates.size() != apriories.size())
+        throw std::invalid_argument("Size of the opinion and the base rates do not match.");
+
+    for (std::size_t i = 0; i < apriories.size(); ++i)
+        if (apriories[i] != baseRates[i])
+            throw std::invalid_argument("Apriories of the opinion and the base rates do not match.");
+
+    return SparseMultinomialOpinion<F>{sparse_beliefs(opinion), opinion.getUncertainty(), std::move(baseRates)};
+}
+
+// Copies the apriories into base rates of their own.
+template<plain_floating_point F, std::size_t N>
+[[nodiscard]] SparseMultinomialOpinion<F> make_sparse(const MultinomialOpinion<F, N> &opinion) {
+    auto apriories{opinion.getApriories()};
+    auto baseRates{BaseRates<F>::shared(std::make_shared<const std::vector<F>>(apriories.begin(), apriories.end()))};
+    return SparseMultinomialOpinion<F>{sparse_beliefs(opinion), opinion.getUncertainty(), std::move(baseRates)};
+}
+
+/*
+ * Cumulative belief fusion of two opinions over the same base rates.
+ * Merges the non-zero beliefs of both opinions in O(nonZeroCount()) time.
+ * Two dogmatic opinions, i.e. without uncertainty, are averaged.
+ *
+ * The uncertainty is derived from the fused beliefs rather than computed
+ * separately, so that rounding errors cannot break the invariant.
+ */
+template<plain_floating_point F>
+[[nodiscard]] SparseMultinomialOpinion<F> cumulative_fuse(const SparseMultinomialOpinion<F> &a,
+                                                          const SparseMultinomialOpinion<F> &b) {
+    if (!a.getBaseRates().sharesWith(b.getBaseRates()))
+        throw std::invalid_argument("Can only fuse opinions sharing the same base rates.");
+
+    F ua {a.getUncertainty()};
+    F ub {b.getUncertainty()};
+    bool dogmatic {ua == F(0) && ub == F(0)};
+    F weightA {dogmatic ? F(0.5) : ub / (ua + ub - ua * ub)};
+    F weightB {dogmatic ? F(0.5) : ua / (ua + ub - ua * ub)};
+
+    auto beliefsA {a.getBeliefs()};
+    auto beliefsB {b.getBeliefs()};
+    std::vector<SparseBelief<F>> fused{};
+    fused.reserve(beliefsA.size() + beliefsB.size());
+
+    auto itA {beliefsA.begin()};
+    auto itB {beliefsB.begin()};
+    while (itA != beliefsA.end() || itB != beliefsB.end()) {
+        if (itB == beliefsB.end() || (itA != beliefsA.end() && itA->index < itB->index)) {
+            fused.push_back({itA->index, weightA * itA->mass});
+            ++itA;
+        } else if (itA == beliefsA.end() || itB->index < itA->index) {
+            fused.push_back({itB->index, weightB * itB->mass});
+            ++itB;
+        } else {
+            fused.push_back({itA->index, weightA * itA->mass + weightB * itB->mass});
+            ++itA;
+            ++itB;
+        }
+    }
+
+    F sum {0};
+    for (auto &belief : fused) {
+        belief.mass = std::min(belief.mass, F(1));
+        sum += belief.mass;
+    }
+
+    F uncertainty {std::max(F(0), F(1) - sum)};
+    return SparseMultinomialOpinion<F>{std::move(fused), uncertainty, a.getBaseRates()};
+}
+
 #endif
@@ -0,0 +1,258 @@
+#ifndef CPPPLAYGROUND_OPINIONGRAPH_H
+#define CPPPLAYGROUND_OPINIONGRAPH_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Incremental computation of opinions derived from other opinions, e.g.
+ * through the operations in Operations.h.
+ *
+ * Input nodes hold plain values, derived nodes hold a function of their input
+ * nodes and cache its result. Setting an input only marks the nodes downstream
+ * of it as dirty, and a dirty node is recomputed only when read, together
+ * with the dirty nodes it depends on. So a change costs in proportion to its
+ * fan-out, and several changes in a row are recomputed in a single batch when
+ * the result is read next.
+ *
+ * A node can only depend on nodes created before it, which rules out cycles
+ * and makes the creation order a topological order for free.
+ *
+ * Not thread-safe. References returned by get() stay valid until the node is
+ * recomputed or set again.
+ */
+class OpinionGraph final {
+public:
+    template<typename T>
+    class Node final {
+    public:
+        using value_type = T;
+
+    private:
+        friend class OpinionGraph;
+
+        [[nodiscard]] explicit constexpr Node(std::size_t index) noexcept : index{index} {}
+
+        std::size_t index;
+    };
+
+    template<typename T>
+    class InputNode final {
+    public:
+        using value_type = T;
+
+        [[nodiscard]] constexpr operator Node<T>() const noexcept {
+            return Node<T>{index};
+        }
+
+    private:
+        friend class OpinionGraph;
+
+        [[nodiscard]] explicit constexpr InputNode(std::size_t index) noexcept : index{index} {}
+
+        std::size_t index;
+    };
+
+    template<typename T>
+    [[nodiscard]] InputNode<T> input(T value) {
+        std::size_t index{nodes.size()};
+        auto node{std::make_unique<ValueNode<T>>()};
+        node->value.emplace(std::move(value));
+        nodes.push_back(std::move(node));
+        return InputNode<T>{index};
+    }
+
+    // The result is computed lazily, on the first read.
+    template<typename Fn, typename... Handles>
+        requires (sizeof...(Handles) > 0)
+              && (std::convertible_to<Handles, Node<typename Handles::value_type>> && ...)
+              && std::invocable<const Fn &, const typename Handles::value_type &...>
+    [[nodiscard]] auto derive(Fn fn, Handles... inputs) {
+        using T = std::remove_cvref_t<std::invoke_result_t<const Fn &, const typename Handles::value_type &...>>;
+        using Derived = DerivedNode<T, Fn, typename Handles::value_type...>;
+
+        std::size_t index{nodes.size()};
+        auto node{std::make_unique<Derived>(std::move(fn), std::array{inputs.index...})};
+        node->dirty = true;
+        nodes.push_back(std::move(node));
+        try {
+            for (std::size_t input : {inputs.index...})
+                nodes[input]->dependents.push_back(index);
+        } catch (...) {
+            // Otherwise the inputs would mark a node as dirty that was never added.
+            for (std::size_t input : {inputs.index...})
+                if (!nodes[input]->dependents.empty() && nodes[input]->dependents.back() == index)
+                    nodes[input]->dependents.pop_back();
+
+            nodes.pop_back();
+            throw;
+        }
+
+        return Node<T>{index};
+    }
+
+    // Marks everything downstream as dirty, without recomputing anything yet.
+    template<typename T>
+    void set(InputNode<T> node, T value) {
+        valueNode<T>(node.index).value = std::move(value);
+        markDependentsDirty(node.index);
+    }
+
+    template<typename T>
+    [[nodiscard]] const T &get(Node<T> node) {
+        refresh(node.index);
+        return *valueNode<T>(node.index).value;
+    }
+
+    // Deduction ignores the conversion of input nodes, hence the overload.
+    template<typename T>
+    [[nodiscard]] const T &get(InputNode<T> node) {
+        return get(Node<T>{node});
+    }
+
+    template<typename T>
+    [[nodiscard]] bool isDirty(Node<T> node) const noexcept {
+        return nodes[node.index]->dirty;
+    }
+
+    template<typename T>
+    [[nodiscard]] bool isDirty(InputNode<T> node) const noexcept {
+        return isDirty(Node<T>{node});
+    }
+
+    // Recomputes all dirty nodes at once.
+    void refresh() {
+        std::vector<std::size_t> pending{};
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            if (nodes[i]->dirty)
+                pending.push_back(i);
+
+        recompute(pending);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return nodes.size();
+    }
+
+    // Number of times a derived node was computed so far.
+    [[nodiscard]] std::size_t recomputations() const noexcept {
+        return recomputationCount;
+    }
+
+private:
+    struct NodeBase {
+        virtual ~NodeBase() noexcept = default;
+        virtual void recompute(const OpinionGraph &graph) = 0;
+        [[nodiscard]] virtual std::span<const std::size_t> inputs() const noexcept = 0;
+
+        std::vector<std::size_t> dependents{};
+        bool dirty{false};
+        std::uint64_t visited{0};
+    };
+
+    template<typename T>
+    struct ValueNode : NodeBase {
+        void recompute(const OpinionGraph &) override {}
+
+        [[nodiscard]] std::span<const std::size_t> inputs() const noexcept override {
+            return {};
+        }
+
+        // optional, as opinions are not default constructible.
+        std::optional<T> value{};
+    };
+
+    template<typename T, typename Fn, typename... Inputs>
+    struct DerivedNode final : ValueNode<T> {
+        [[nodiscard]] DerivedNode(Fn fn, std::array<std::size_t, sizeof...(Inputs)> inputIndices)
+            : fn{std::move(fn)}, inputIndices{inputIndices} {}
+
+        void recompute(const OpinionGraph &graph) override {
+            // Resetting first allows types without assignment and frees the old
+            // value before computing the new one.
+            this->value.reset();
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                this->value.emplace(std::invoke(fn, *graph.valueNode<Inputs>(inputIndices[I]).value...));
+            }(std::index_sequence_for<Inputs...>{});
+        }
+
+        [[nodiscard]] std::span<const std::size_t> inputs() const noexcept override {
+            return inputIndices;
+        }
+
+        Fn fn;
+        std::array<std::size_t, sizeof...(Inputs)> inputIndices;
+    };
+
+    template<typename T>
+    [[nodiscard]] ValueNode<T> &valueNode(std::size_t index) const noexcept {
+        return static_cast<ValueNode<T> &>(*nodes[index]);
+    }
+
+    // Dependents of a dirty node are dirty already, so the walk stops there.
+    void markDependentsDirty(std::size_t index) {
+        std::vector<std::size_t> stack{nodes[index]->dependents};
+        while (!stack.empty()) {
+            NodeBase &node{*nodes[stack.back()]};
+            stack.pop_back();
+            if (node.dirty)
+                continue;
+
+            node.dirty = true;
+            stack.insert(stack.end(), node.dependents.begin(), node.dependents.end());
+        }
+    }
+
+    // Recomputes the node and all dirty nodes it depends on.
+    void refresh(std::size_t index) {
+        if (!nodes[index]->dirty)
+            return;
+
+        ++visitGeneration;
+        std::vector<std::size_t> pending{};
+        std::vector<std::size_t> stack{index};
+        nodes[index]->visited = visitGeneration;
+        while (!stack.empty()) {
+            std::size_t current{stack.back()};
+            stack.pop_back();
+            pending.push_back(current);
+            for (std::size_t input : nodes[current]->inputs()) {
+                NodeBase &node{*nodes[input]};
+                if (node.dirty && node.visited != visitGeneration) {
+                    node.visited = visitGeneration;
+                    stack.push_back(input);
+                }
+            }
+        }
+
+        std::ranges::sort(pending);
+        recompute(pending);
+    }
+
+    // Requires pending to be sorted, i.e. in topological order. If a function
+    // throws, the node and everything after it stay dirty.
+    void recompute(std::span<const std::size_t> pending) {
+        for (std::size_t index : pending) {
+            NodeBase &node{*nodes[index]};
+            node.recompute(*this);
+            node.dirty = false;
+            ++recomputationCount;
+        }
+    }
+
+    std::vector<std::unique_ptr<NodeBase>> nodes{};
+    std::uint64_t visitGeneration{0};
+    std::size_t recomputationCount{0};
+};
+
+#endif
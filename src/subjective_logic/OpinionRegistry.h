@@ -0,0 +1,293 @@
+#ifndef CPPPLAYGROUND_OPINIONREGISTRY_H
+#define CPPPLAYGROUND_OPINIONREGISTRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+ * Table of entity id -> opinion that many threads read and a few update.
+ *
+ * Reads are wait-free: A reader announces the current epoch in a slot of its
+ * own, walks a bucket chain and takes the pointer to the current version of
+ * the opinion. It never writes shared memory and never waits for a writer.
+ * Versions are immutable, so a pointer obtained within a Snapshot stays valid
+ * and unchanged until the snapshot ends, even if a newer version gets
+ * published in the meantime.
+ *
+ * Writers serialise on a mutex, publish new versions with a single atomic
+ * exchange and retire the old version together with the current epoch. The
+ * epoch only advances once every active reader has announced it, so anything
+ * retired two epochs ago can no longer be reached by any reader and is freed.
+ *
+ * The number of buckets is fixed at construction, so pick it in the order of
+ * the expected number of entities.
+ */
+template<typename Opinion>
+    requires std::move_constructible<Opinion>
+class OpinionRegistry final {
+    struct Node;
+    struct ReaderSlot;
+
+public:
+    using Id = std::uint64_t;
+
+    [[nodiscard]] explicit OpinionRegistry(std::size_t buckets = 1024, std::size_t maxReaders = 64)
+        : buckets(std::bit_ceil(std::max<std::size_t>(buckets, 2))),
+          shift{static_cast<unsigned>(std::numeric_limits<Id>::digits - std::countr_zero(this->buckets.size()))},
+          readerSlots(maxReaders) {
+        if (maxReaders == 0)
+            throw std::invalid_argument("Require at least one reader slot.");
+    }
+
+    OpinionRegistry(const OpinionRegistry &) = delete;
+    OpinionRegistry &operator=(const OpinionRegistry &) = delete;
+
+    // Requires that all readers are gone.
+    ~OpinionRegistry() noexcept {
+        for (auto &bucket : buckets) {
+            Node *node{bucket.load(std::memory_order_relaxed)};
+            while (node != nullptr) {
+                Node *next{node->next.load(std::memory_order_relaxed)};
+                delete node->opinion.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+    }
+
+    class Reader;
+
+    // Pins the current epoch. Pointers obtained through it stay valid until it ends.
+    class Snapshot final {
+    public:
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        ~Snapshot() noexcept {
+            slot.epoch.store(idle, std::memory_order_release);
+        }
+
+        // Returns nullptr if there is no opinion for the given id.
+        [[nodiscard]] const Opinion *find(Id id) const noexcept {
+            const Node *node{registry.bucketOf(id).load(std::memory_order_acquire)};
+            for (; node != nullptr; node = node->next.load(std::memory_order_acquire)) {
+                if (node->id == id)
+                    return node->opinion.load(std::memory_order_acquire);
+            }
+
+            return nullptr;
+        }
+
+    private:
+        friend class Reader;
+
+        [[nodiscard]] Snapshot(const OpinionRegistry &registry, ReaderSlot &slot) noexcept
+            : registry{registry}, slot{slot} {
+            slot.epoch.store(registry.epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            // Pairs with the fence in tryAdvanceEpoch(): Either the writer sees
+            // this announcement or this reader sees everything unlinked before.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        const OpinionRegistry &registry;
+        ReaderSlot &slot;
+    };
+
+    // Handle of a single reader thread. Claims one of the reader slots for its
+    // whole lifetime, so that taking a snapshot does not touch shared memory.
+    class Reader final {
+    public:
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        ~Reader() noexcept {
+            slot.claimed.store(false, std::memory_order_release);
+        }
+
+        // At most one snapshot per reader may exist at any time.
+        [[nodiscard]] Snapshot snapshot() const noexcept {
+            return Snapshot{registry, slot};
+        }
+
+        // Calls fn with the current version of the opinion, or nullptr.
+        template<std::invocable<const Opinion *> Fn>
+        decltype(auto) read(Id id, Fn &&fn) const {
+            Snapshot pinned{snapshot()};
+            return std::forward<Fn>(fn)(pinned.find(id));
+        }
+
+    private:
+        friend class OpinionRegistry;
+
+        [[nodiscard]] Reader(const OpinionRegistry &registry, ReaderSlot &slot) noexcept
+            : registry{registry}, slot{slot} {}
+
+        const OpinionRegistry &registry;
+        ReaderSlot &slot;
+    };
+
+    // Throws std::length_error if all reader slots are claimed.
+    [[nodiscard]] Reader reader() const {
+        for (auto &slot : readerSlots) {
+            bool expected{false};
+            if (!slot.claimed.load(std::memory_order_relaxed)
+                && slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return Reader{*this, slot};
+        }
+
+        throw std::length_error("All reader slots are claimed.");
+    }
+
+    // Inserts the opinion or replaces the current version.
+    void publish(Id id, Opinion opinion) {
+        auto version{std::make_unique<const Opinion>(std::move(opinion))};
+        std::scoped_lock lock{writerMutex};
+        reserveRetired();
+
+        auto &bucket{bucketOf(id)};
+        Node *head{bucket.load(std::memory_order_relaxed)};
+        for (Node *node = head; node != nullptr; node = node->next.load(std::memory_order_relaxed)) {
+            if (node->id == id) {
+                const Opinion *old{node->opinion.exchange(version.release(), std::memory_order_acq_rel)};
+                retire(std::unique_ptr<const Opinion>{old}, nullptr);
+                return;
+            }
+        }
+
+        auto node{std::make_unique<Node>(id, version.get(), head)};
+        std::ignore = version.release();
+        bucket.store(node.release(), std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+        reclaimLocked();
+    }
+
+    // Returns whether there was an opinion for the given id.
+    bool erase(Id id) {
+        std::scoped_lock lock{writerMutex};
+        reserveRetired();
+
+        std::atomic<Node *> *link{&bucketOf(id)};
+        for (Node *node = link->load(std::memory_order_relaxed); node != nullptr;
+             node = link->load(std::memory_order_relaxed)) {
+            if (node->id == id) {
+                // The node keeps pointing to its successor, so that readers
+                // currently standing on it can continue their walk.
+                link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+                count.fetch_sub(1, std::memory_order_relaxed);
+                retire(std::unique_ptr<const Opinion>{node->opinion.load(std::memory_order_relaxed)},
+                       std::unique_ptr<Node>{node});
+                return true;
+            }
+
+            link = &node->next;
+        }
+
+        return false;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    // Number of retired versions and entries that still wait to be freed.
+    [[nodiscard]] std::size_t pendingReclamation() const {
+        std::scoped_lock lock{writerMutex};
+        return retired.size();
+    }
+
+    // Frees whatever the readers allow. Writers do this on every update anyway.
+    void reclaim() {
+        std::scoped_lock lock{writerMutex};
+        reclaimLocked();
+    }
+
+private:
+    static constexpr std::size_t cacheLineSize{64};
+    static constexpr std::uint64_t idle{std::numeric_limits<std::uint64_t>::max()};
+
+    struct Node final {
+        [[nodiscard]] Node(Id id, const Opinion *opinion, Node *next) noexcept
+            : id{id}, opinion{opinion}, next{next} {}
+
+        const Id id;
+        std::atomic<const Opinion *> opinion;
+        std::atomic<Node *> next;
+    };
+
+    struct alignas(cacheLineSize) ReaderSlot final {
+        std::atomic<std::uint64_t> epoch{idle};
+        std::atomic<bool> claimed{false};
+    };
+
+    struct Retired final {
+        std::uint64_t epoch;
+        std::unique_ptr<const Opinion> opinion;
+        std::unique_ptr<Node> node;
+    };
+
+    [[nodiscard]] std::atomic<Node *> &bucketOf(Id id) noexcept {
+        return buckets[(id * 0x9e3779b97f4a7c15) >> shift];
+    }
+
+    [[nodiscard]] const std::atomic<Node *> &bucketOf(Id id) const noexcept {
+        return buckets[(id * 0x9e3779b97f4a7c15) >> shift];
+    }
+
+    // Requires the writer mutex. Keeps retire() from throwing halfway through an update.
+    void reserveRetired() {
+        if (retired.size() == retired.capacity())
+            retired.reserve(2 * retired.size() + 8);
+    }
+
+    // Requires the writer mutex and a call to reserveRetired() before.
+    void retire(std::unique_ptr<const Opinion> opinion, std::unique_ptr<Node> node) noexcept {
+        retired.push_back({epoch.load(std::memory_order_relaxed), std::move(opinion), std::move(node)});
+        reclaimLocked();
+    }
+
+    // Requires the writer mutex.
+    void reclaimLocked() noexcept {
+        if (retired.empty())
+            return;
+
+        tryAdvanceEpoch();
+        const std::uint64_t current{epoch.load(std::memory_order_relaxed)};
+        std::erase_if(retired, [current](const Retired &r) { return r.epoch + 2 <= current; });
+    }
+
+    // Requires the writer mutex.
+    void tryAdvanceEpoch() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint64_t current{epoch.load(std::memory_order_relaxed)};
+        for (const auto &slot : readerSlots) {
+            std::uint64_t announced{slot.epoch.load(std::memory_order_acquire)};
+            if (announced != idle && announced != current)
+                return;
+        }
+
+        epoch.store(current + 1, std::memory_order_relaxed);
+    }
+
+    std::vector<std::atomic<Node *>> buckets;
+    unsigned shift;
+    mutable std::vector<ReaderSlot> readerSlots;
+
+    alignas(cacheLineSize) std::atomic<std::uint64_t> epoch{0};
+    std::atomic<std::size_t> count{0};
+
+    alignas(cacheLineSize) mutable std::mutex writerMutex{};
+    std::vector<Retired> retired{};
+};
+
+#endif
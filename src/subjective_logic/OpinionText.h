@@ -0,0 +1,315 @@
+#ifndef CPPPLAYGROUND_OPINIONTEXT_H
+#define CPPPLAYGROUND_OPINIONTEXT_H
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "floatingPointHelper.h"
+#include "BinomialOpinion.h"
+#include "MultinomialOpinion.h"
+
+/*
+ * Text representation of opinions built on std::to_chars and std::from_chars.
+ * All numbers are written in their shortest form that parses back to the very
+ * same value, so formatting and parsing round-trips exactly.
+ *
+ * A binomial opinion is written as `belief disbelief uncertainty apriori`, a
+ * multinomial opinion of size n as `uncertainty` followed by n beliefs and n
+ * apriories, all separated by a single space. The batch functions write one
+ * opinion per line and skip empty lines when parsing.
+ *
+ * Like std::to_chars and std::from_chars, the functions report malformed text
+ * or too small buffers through an error code. Numbers that are well-formed,
+ * but do not make up a valid opinion, throw std::invalid_argument just like
+ * the constructors of the opinions do.
+ */
+
+template<plain_floating_point F>
+inline constexpr std::size_t max_formatted_number_size{
+        // Sign, decimal point, 'e', sign of the exponent and its digits.
+        std::numeric_limits<F>::max_digits10 + 4
+        + (std::numeric_limits<F>::max_exponent10 >= 1000 ? 4 : 3)};
+
+// Upper bound on the size of count numbers separated by single spaces.
+template<plain_floating_point F>
+[[nodiscard]] constexpr std::size_t max_formatted_size(std::size_t count) noexcept {
+    return count * (max_formatted_number_size<F> + 1);
+}
+
+template<plain_floating_point F>
+[[nodiscard]] constexpr std::size_t max_formatted_size(const BinomialOpinion<F> &) noexcept {
+    return max_formatted_size<F>(4);
+}
+
+template<plain_floating_point F, std::size_t N>
+[[nodiscard]] constexpr std::size_t max_formatted_size(const MultinomialOpinion<F, N> &opinion) noexcept {
+    return max_formatted_size<F>(2 * opinion.size() + 1);
+}
+
+template<plain_floating_point F>
+[[nodiscard]] std::to_chars_result format_numbers(char *first, char *last, std::span<const F> values,
+                                                  bool leadingSpace = false) noexcept {
+    for (F value : values) {
+        if (leadingSpace) {
+            if (first == last)
+                return {last, std::errc::value_too_large};
+
+            *first++ = ' ';
+        }
+
+        auto result{std::to_chars(first, last, value)};
+        if (result.ec != std::errc{})
+            return result;
+
+        first = result.ptr;
+        leadingSpace = true;
+    }
+
+    return {first, std::errc{}};
+}
+
+template<plain_floating_point F>
+[[nodiscard]] std::to_chars_result format_opinion(char *first, char *last, const BinomialOpinion<F> &opinion) noexcept {
+    const std::array values{opinion.getBelief(), opinion.getDisbelief(),
+                            opinion.getUncertainty(), opinion.getApriori()};
+    return format_numbers<F>(first, last, values);
+}
+
+template<plain_floating_point F, std::size_t N>
+[[nodiscard]] std::to_chars_result format_opinion(char *first, char *last, const MultinomialOpinion<F, N> &opinion) noexcept {
+    const std::array uncertainty{opinion.getUncertainty()};
+    auto result{format_numbers<F>(first, last, uncertainty)};
+    if (result.ec == std::errc{})
+        result = format_numbers<F>(result.ptr, last, opinion.getBeliefs(), true);
+    if (result.ec == std::errc{})
+        result = format_numbers<F>(result.ptr, last, opinion.getApriories(), true);
+
+    return result;
+}
+
+template<typename Opinion>
+concept text_formattable_opinion = requires(char *p, const Opinion &opinion) {
+    { format_opinion(p, p, opinion) } -> std::same_as<std::to_chars_result>;
+    { max_formatted_size(opinion) } -> std::same_as<std::size_t>;
+};
+
+template<typename R>
+concept text_formattable_opinion_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+        && text_formattable_opinion<std::ranges::range_value_t<R>>;
+
+// Writes one opinion per line into the caller provided buffer.
+template<text_formattable_opinion_range R>
+[[nodiscard]] std::to_chars_result format_opinions(char *first, char *last, const R &opinions) noexcept {
+    for (const auto &opinion : opinions) {
+        auto result{format_opinion(first, last, opinion)};
+        if (result.ec != std::errc{})
+            return result;
+
+        if (result.ptr == last)
+            return {last, std::errc::value_too_large};
+
+        *result.ptr = '\n';
+        first = result.ptr + 1;
+    }
+
+    return {first, std::errc{}};
+}
+
+// Appends one opinion per line to out.
+// Works in blocks, so that the scratch space reserved for the worst case stays
+// in the cache instead of zero filling the whole upper bound at once.
+template<text_formattable_opinion_range R>
+void format_opinions(const R &opinions, std::string &out) {
+    constexpr std::size_t blockSize{256};
+    std::span all{std::ranges::data(opinions), std::ranges::size(opinions)};
+    for (std::size_t offset = 0; offset < all.size(); offset += blockSize) {
+        auto block{all.subspan(offset, std::min(blockSize, all.size() - offset))};
+        std::size_t bound{0};
+        for (const auto &opinion : block)
+            bound += max_formatted_size(opinion) + 1;
+
+        std::size_t begin{out.size()};
+        out.resize(begin + bound);
+        auto result{format_opinions(out.data() + begin, out.data() + out.size(), block)};
+        out.resize(static_cast<std::size_t>(result.ptr - out.data()));
+    }
+}
+
+[[nodiscard]] constexpr bool is_number_separator(char c) noexcept {
+    return c == ' ' || c == '\t';
+}
+
+[[nodiscard]] constexpr bool is_line_end(char c) noexcept {
+    return c == '\n' || c == '\r';
+}
+
+[[nodiscard]] constexpr const char *skip_number_separators(const char *first, const char *last) noexcept {
+    while (first != last && is_number_separator(*first))
+        ++first;
+
+    return first;
+}
+
+// Parses a single number, which must be followed by a separator, a line end or last.
+template<plain_floating_point F>
+[[nodiscard]] std::from_chars_result parse_number(const char *first, const char *last, F &value) noexcept {
+    first = skip_number_separators(first, last);
+    auto result{std::from_chars(first, last, value)};
+    if (result.ec == std::errc{} && result.ptr != last
+        && !is_number_separator(*result.ptr) && !is_line_end(*result.ptr))
+        return {result.ptr, std::errc::invalid_argument};
+
+    return result;
+}
+
+// Parses exactly values.size() numbers.
+template<plain_floating_point F>
+[[nodiscard]] std::from_chars_result parse_numbers(const char *first, const char *last, std::span<F> values) noexcept {
+    for (F &value : values) {
+        auto result{parse_number(first, last, value)};
+        if (result.ec != std::errc{})
+            return result;
+
+        first = result.ptr;
+    }
+
+    return {first, std::errc{}};
+}
+
+// Parses numbers until the end of the line or last.
+template<plain_floating_point F>
+[[nodiscard]] std::from_chars_result parse_line_numbers(const char *first, const char *last, std::vector<F> &values) {
+    values.clear();
+    while (true) {
+        first = skip_number_separators(first, last);
+        if (first == last || is_line_end(*first))
+            return {first, std::errc{}};
+
+        F value{};
+        auto result{parse_number(first, last, value)};
+        if (result.ec != std::errc{})
+            return result;
+
+        values.push_back(value);
+        first = result.ptr;
+    }
+}
+
+template<typename Opinion>
+struct ParsedOpinion final {
+    const char *ptr;
+    std::errc ec;
+    // Only set if ec is std::errc{}.
+    std::optional<Opinion> opinion;
+};
+
+template<plain_floating_point F>
+[[nodiscard]] ParsedOpinion<BinomialOpinion<F>> parse_binomial(const char *first, const char *last) {
+    std::array<F, 4> values{};
+    auto [ptr, ec] {parse_numbers<F>(first, last, values)};
+    if (ec != std::errc{})
+        return {ptr, ec, std::nullopt};
+
+    return {ptr, ec, BinomialOpinion<F>{values[0], values[1], values[2], values[3]}};
+}
+
+template<plain_floating_point F, std::size_t N>
+    requires (N != std::dynamic_extent)
+[[nodiscard]] ParsedOpinion<MultinomialOpinion<F, N>> parse_multinomial(const char *first, const char *last) {
+    std::array<F, 2 * N + 1> values{};
+    auto [ptr, ec] {parse_numbers<F>(first, last, values)};
+    if (ec != std::errc{})
+        return {ptr, ec, std::nullopt};
+
+    std::span<const F, 2 * N + 1> numbers{values};
+    return {ptr, ec, MultinomialOpinion<F, N>{numbers.template subspan<1, N>(), values[0], numbers.template subspan<1 + N, N>()}};
+}
+
+// Reads the rest of the line. The scratch buffer only avoids allocations when
+// parsing many opinions.
+template<plain_floating_point F, std::size_t N>
+    requires (N == std::dynamic_extent)
+[[nodiscard]] ParsedOpinion<MultinomialOpinion<F, N>> parse_multinomial(const char *first, const char *last,
+                                                                        std::vector<F> &scratch) {
+    auto [ptr, ec] {parse_line_numbers(first, last, scratch)};
+    if (ec != std::errc{})
+        return {ptr, ec, std::nullopt};
+
+    if (scratch.size() < 5 || scratch.size() % 2 == 0)
+        return {ptr, std::errc::invalid_argument, std::nullopt};
+
+    std::span<const F> numbers{scratch};
+    std::size_t size{(numbers.size() - 1) / 2};
+    return {ptr, ec, MultinomialOpinion<F, N>{numbers.subspan(1, size), numbers[0], numbers.subspan(1 + size, size)}};
+}
+
+template<plain_floating_point F, std::size_t N>
+    requires (N == std::dynamic_extent)
+[[nodiscard]] ParsedOpinion<MultinomialOpinion<F, N>> parse_multinomial(const char *first, const char *last) {
+    std::vector<F> scratch{};
+    return parse_multinomial<F, N>(first, last, scratch);
+}
+
+// Parses one opinion per line and appends them to out. Stops at the first error.
+template<typename Opinion, typename Parse>
+[[nodiscard]] std::from_chars_result parse_opinion_lines(std::string_view text, std::vector<Opinion> &out, Parse parse) {
+    const char *first{text.data()};
+    const char *const last{first + text.size()};
+    while (first != last) {
+        first = skip_number_separators(first, last);
+        if (first != last && is_line_end(*first)) {
+            ++first;
+            continue;
+        }
+
+        if (first == last)
+            break;
+
+        auto [ptr, ec, opinion] {parse(first, last)};
+        if (ec != std::errc{})
+            return {ptr, ec};
+
+        ptr = skip_number_separators(ptr, last);
+        if (ptr != last && !is_line_end(*ptr))
+            return {ptr, std::errc::invalid_argument};
+
+        out.push_back(std::move(*opinion));
+        first = ptr;
+    }
+
+    return {first, std::errc{}};
+}
+
+template<plain_floating_point F>
+[[nodiscard]] std::from_chars_result parse_opinions(std::string_view text, std::vector<BinomialOpinion<F>> &out) {
+    return parse_opinion_lines(text, out, [](const char *first, const char *last) {
+        return parse_binomial<F>(first, last);
+    });
+}
+
+template<plain_floating_point F, std::size_t N>
+[[nodiscard]] std::from_chars_result parse_opinions(std::string_view text, std::vector<MultinomialOpinion<F, N>> &out) {
+    if constexpr (N == std::dynamic_extent) {
+        std::vector<F> scratch{};
+        return parse_opinion_lines(text, out, [&scratch](const char *first, const char *last) {
+            return parse_multinomial<F, N>(first, last, scratch);
+        });
+    } else {
+        return parse_opinion_lines(text, out, [](const char *first, const char *last) {
+            return parse_multinomial<F, N>(first, last);
+        });
+    }
+}
+
+#endif
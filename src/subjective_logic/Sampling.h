@@ -0,0 +1,422 @@
+#ifndef CPPPLAYGROUND_SAMPLING_H
+#define CPPPLAYGROUND_SAMPLING_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "floatingPointHelper.h"
+#include "BinomialOpinion.h"
+#include "MultinomialOpinion.h"
+
+/*
+ * Monte Carlo sampling of the probability distributions behind opinions:
+ * A multinomial opinion corresponds to the Dirichlet distribution with
+ * `alpha[x] = W * belief[x] / uncertainty + W * apriori[x]`, a binomial
+ * opinion to the Beta distribution with the analogous parameters, where W is
+ * the weight of the non-informative prior.
+ *
+ * Random numbers come from the counter-based Philox4x32-10 generator. Every
+ * draw is a pure function of the seed, the index of the sample, the category
+ * and the attempt of the rejection sampler, so the results are reproducible
+ * and do not depend on how the samples are split across threads. Unlike a
+ * sequential generator, the counters of consecutive samples are independent,
+ * which lets the compiler vectorise the loops over a batch of samples.
+ *
+ * Gamma variates use the method of Marsaglia and Tsang. A batch of samples
+ * first makes one attempt in every lane without branching and only the few
+ * rejected lanes (around 2 to 5 percent) are retried one by one. The standard
+ * log, cos and sqrt are scalar library calls as long as errno is set, thus the
+ * attempts use the branchless_* functions below instead. With -O3 and AVX2,
+ * GCC vectorises the first attempts, which roughly triples the throughput.
+ */
+
+struct SamplingOptions final {
+    std::uint64_t seed{0};
+    std::size_t threads{std::thread::hardware_concurrency()};
+    double priorWeight{2.0};
+};
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+[[nodiscard]] constexpr PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key) noexcept {
+    constexpr std::uint64_t multiplier0{0xd2511f53};
+    constexpr std::uint64_t multiplier1{0xcd9e8d57};
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t product0{multiplier0 * counter[0]};
+        std::uint64_t product1{multiplier1 * counter[2]};
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<std::uint32_t>(product1),
+                   static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<std::uint32_t>(product0)};
+        key[0] += 0x9e3779b9;
+        key[1] += 0xbb67ae85;
+    }
+
+    return counter;
+}
+
+/*
+ * Integer to double conversions via the bits of 2^52 + i, as x86 has no
+ * vector instruction for unsigned 32 and 64 bit integers before AVX-512.
+ * Exact for i < 2^52.
+ */
+[[nodiscard]] constexpr double exact_to_double(std::uint64_t i) noexcept {
+    return std::bit_cast<double>(std::bit_cast<std::uint64_t>(0x1p52) | i) - 0x1p52;
+}
+
+// Uniformly distributed in the open interval (0, 1), so that its logarithm is finite.
+[[nodiscard]] constexpr double uniform_open(std::uint32_t bits) noexcept {
+    return (exact_to_double(bits) + 0.5) * 0x1p-32;
+}
+
+/*
+ * Elementary functions for the sampler, without branches, errno or library
+ * calls, so that loops using them vectorise without -ffast-math. They are
+ * accurate to a few ulp on the arguments noted for each, but do not handle
+ * infinities, NaNs or subnormals.
+ */
+
+/*
+ * condition ? a : b via bit masks. GCC does not turn conditional expressions
+ * into vector blends if an operand is computed only for the selected case,
+ * which it assumes for any floating point operation in them.
+ */
+[[nodiscard]] constexpr double branchless_select(bool condition, double a, double b) noexcept {
+    std::uint64_t mask{0 - static_cast<std::uint64_t>(condition)};
+    return std::bit_cast<double>((std::bit_cast<std::uint64_t>(a) & mask) | (std::bit_cast<std::uint64_t>(b) & ~mask));
+}
+
+template<std::size_t N, std::size_t... K>
+[[nodiscard]] constexpr std::array<double, sizeof...(K)> pair_coefficients(const std::array<double, N> &coefficients, double x,
+                                                                           std::index_sequence<K...>) noexcept {
+    return {(2 * K + 1 < N ? coefficients[2 * K] + coefficients[2 * K + 1] * x : coefficients[2 * K])...};
+}
+
+// Estrin's scheme: Unlike with Horner's, most multiply-adds are independent.
+// Unrolled at compile time, so that it does not hinder the vectorisation of loops using it.
+template<std::size_t N>
+[[nodiscard]] constexpr double evaluate_polynomial(const std::array<double, N> &coefficients, double x) noexcept {
+    if constexpr (N == 1) {
+        return coefficients[0];
+    } else {
+        return evaluate_polynomial(pair_coefficients(coefficients, x, std::make_index_sequence<(N + 1) / 2>{}), x * x);
+    }
+}
+
+// 1 / (2k + 1), the series of atanh(s) / s in s^2.
+inline constexpr auto log_coefficients{[] {
+    std::array<double, 12> coefficients{};
+    for (std::size_t k = 0; k < coefficients.size(); ++k)
+        coefficients[k] = 1.0 / static_cast<double>(2 * k + 1);
+
+    return coefficients;
+}()};
+
+// 1 / k!, the Taylor series of exp(r).
+inline constexpr auto exp_coefficients{[] {
+    std::array<double, 14> coefficients{};
+    double factorial{1.0};
+    for (std::size_t k = 0; k < coefficients.size(); ++k) {
+        factorial *= k == 0 ? 1.0 : static_cast<double>(k);
+        coefficients[k] = 1.0 / factorial;
+    }
+
+    return coefficients;
+}()};
+
+// (-1)^k / (2k)!, the Taylor series of cos(x) in x^2.
+inline constexpr auto cos_coefficients{[] {
+    std::array<double, 12> coefficients{};
+    double factorial{1.0};
+    for (std::size_t k = 0; k < coefficients.size(); ++k) {
+        factorial *= k == 0 ? 1.0 : static_cast<double>((2 * k - 1) * 2 * k);
+        coefficients[k] = (k % 2 == 0 ? 1.0 : -1.0) / factorial;
+    }
+
+    return coefficients;
+}()};
+
+inline constexpr double ln2_hi{0x1.62e42fee00000p-1};
+inline constexpr double ln2_lo{0x1.a39ef35793c76p-33};
+
+// Requires x > 0.
+[[nodiscard]] constexpr double branchless_log(double x) noexcept {
+    // x = 2^e m with m in [sqrt(0.5), sqrt(2)), by moving where the exponent rounds up.
+    constexpr std::uint64_t sqrtHalf{0x3fe6a09e667f3bcd};
+    constexpr std::uint64_t one{0x3ff0000000000000};
+    constexpr std::uint64_t mantissa{(std::uint64_t{1} << 52) - 1};
+    std::uint64_t shifted{std::bit_cast<std::uint64_t>(x) + (one - sqrtHalf)};
+    double e{exact_to_double(shifted >> 52) - 1023.0};
+    double m{std::bit_cast<double>((shifted & mantissa) + sqrtHalf)};
+
+    // log(m) = 2 atanh(s) with |s| < 0.172.
+    double s{(m - 1.0) / (m + 1.0)};
+    return e * ln2_hi + (2.0 * s * evaluate_polynomial(log_coefficients, s * s) + e * ln2_lo);
+}
+
+// Requires x <= 0. Flushes results below exp(-708), close to the smallest normal double, to zero.
+[[nodiscard]] constexpr double branchless_exp(double x) noexcept {
+    constexpr double roundingShift{0x1.8p52};
+    bool underflows{x < -708.0};
+    x = branchless_select(underflows, -708.0, x);
+
+    // exp(x) = 2^n exp(r) with x = n ln(2) + r, n integral and |r| <= ln(2) / 2.
+    double shifted{x * std::numbers::log2e + roundingShift};
+    double n{shifted - roundingShift};
+    double r{(x - n * ln2_hi) - n * ln2_lo};
+    std::uint64_t exponent{std::bit_cast<std::uint64_t>(shifted) - std::bit_cast<std::uint64_t>(roundingShift) + 1023};
+    double result{evaluate_polynomial(exp_coefficients, r) * std::bit_cast<double>(exponent << 52)};
+    return branchless_select(underflows, 0.0, result);
+}
+
+// Requires x >= 0.
+[[nodiscard]] constexpr double branchless_sqrt(double x) noexcept {
+    // Newton's method for 1 / sqrt(x), starting within 4 percent of it, doubles
+    // the correct digits per step. The last step refines the root itself.
+    double inverse{std::bit_cast<double>(std::uint64_t{0x5fe6eb50c7b537a9} - (std::bit_cast<std::uint64_t>(x) >> 1))};
+    for (int i = 0; i < 3; ++i)
+        inverse *= 1.5 - 0.5 * x * inverse * inverse;
+
+    double root{x * inverse};
+    root += 0.5 * inverse * (x - root * root);
+    return branchless_select(x > 0.0, root, 0.0);
+}
+
+// cos(2 pi u), requires u in [0, 1].
+[[nodiscard]] constexpr double branchless_cos_two_pi(double u) noexcept {
+    // Reduced to an angle in [0, pi / 2] by the symmetries of the cosine.
+    double a{branchless_select(u < 0.5, u, 1.0 - u)};
+    bool negated{a > 0.25};
+    double angle{2.0 * std::numbers::pi * branchless_select(negated, 0.5 - a, a)};
+    double result{evaluate_polynomial(cos_coefficients, angle * angle)};
+    return branchless_select(negated, -result, result);
+}
+
+inline constexpr std::size_t sampling_batch_size{32};
+
+class GammaSampler final {
+public:
+    [[nodiscard]] GammaSampler(double shape, std::uint64_t seed, std::uint32_t stream) noexcept
+        : shape{shape}, inverseShape{1.0 / shape}, boosted{shape < 1.0}, d{(boosted ? shape + 1.0 : shape) - 1.0 / 3.0},
+          c{1.0 / std::sqrt(9.0 * d)}, key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+          stream{stream} {}
+
+    // Writes the variates of the samples first, first + 1, ... into out.
+    void operator()(std::uint64_t first, std::span<double> out) const noexcept {
+        if (shape == 0.0) {
+            std::ranges::fill(out, 0.0);
+            return;
+        }
+
+        // Local, as out might alias the members for all the compiler knows.
+        std::array<double, sampling_batch_size> values{};
+        std::array<bool, sampling_batch_size> accepted{};
+        for (std::size_t offset = 0; offset < out.size(); offset += sampling_batch_size) {
+            std::size_t lanes{std::min(sampling_batch_size, out.size() - offset)};
+            if (boosted) {
+                attemptBatch<true>(first + offset, lanes, values, accepted);
+            } else {
+                attemptBatch<false>(first + offset, lanes, values, accepted);
+            }
+
+            std::copy_n(values.begin(), lanes, out.begin() + static_cast<std::ptrdiff_t>(offset));
+        }
+    }
+
+private:
+    // The first attempts of all lanes are vectorised, only the rejected lanes retry one by one.
+    template<bool Boosted>
+    void attemptBatch(std::uint64_t first, std::size_t lanes, std::array<double, sampling_batch_size> &values,
+                      std::array<bool, sampling_batch_size> &accepted) const noexcept {
+        for (std::size_t j = 0; j < lanes; ++j)
+            accepted[j] = attempt<Boosted>(first + j, 0, values[j]);
+
+        for (std::size_t j = 0; j < lanes; ++j) {
+            for (std::uint32_t n = 1; !accepted[j]; ++n)
+                accepted[j] = attempt<Boosted>(first + j, n, values[j]);
+        }
+    }
+
+    // One Philox block yields the four uniforms an attempt needs: two for the
+    // normal variate, one to accept it and one to boost shapes below one.
+    // Without branches, so that the loop over the lanes vectorises.
+    template<bool Boosted>
+    [[nodiscard]] bool attempt(std::uint64_t sample, std::uint32_t attempt, double &value) const noexcept {
+        PhiloxCounter bits{philox4x32({static_cast<std::uint32_t>(sample), static_cast<std::uint32_t>(sample >> 32),
+                                       stream, attempt}, key)};
+        double radius{branchless_sqrt(-2.0 * branchless_log(uniform_open(bits[0])))};
+        double normal{radius * branchless_cos_two_pi(uniform_open(bits[1]))};
+
+        double v{1.0 + c * normal};
+        v = v * v * v;
+        value = d * v;
+        // Boosting multiplies by u^(1 / shape).
+        if constexpr (Boosted)
+            value *= branchless_exp(branchless_log(uniform_open(bits[3])) * inverseShape);
+
+        // The logarithm of v is only used if v is positive.
+        double logV{branchless_log(branchless_select(v > 0.0, v, 1.0))};
+        return (v > 0.0) & (branchless_log(uniform_open(bits[2])) < 0.5 * normal * normal + d - d * v + d * logV);
+    }
+
+    double shape;
+    double inverseShape;
+    bool boosted;
+    double d;
+    double c;
+    PhiloxKey key;
+    std::uint32_t stream;
+};
+
+/*
+ * Splits the samples [0, count) into contiguous ranges, one per thread. If fn
+ * throws, the exception of the first failing range is rethrown once all
+ * threads are done, rather than terminating the program from a thread.
+ */
+template<typename Fn>
+void parallel_samples(std::size_t count, std::size_t threads, Fn fn) {
+    threads = std::clamp<std::size_t>((count + sampling_batch_size - 1) / sampling_batch_size, 1, std::max<std::size_t>(threads, 1));
+    std::size_t chunk{(count + threads - 1) / threads};
+
+    std::vector<std::exception_ptr> errors(threads);
+    auto run {
+        [&fn, &errors](std::size_t range, std::size_t begin, std::size_t end) noexcept {
+            try {
+                fn(begin, end);
+            } catch (...) {
+                errors[range] = std::current_exception();
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1);
+        std::size_t begin{0};
+        std::size_t range{0};
+        for (; range + 1 < threads && begin < count; ++range, begin += chunk)
+            workers.emplace_back(run, range, begin, std::min(begin + chunk, count));
+
+        if (begin < count)
+            run(range, begin, count);
+    }
+
+    for (const auto &error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+/*
+ * Draws count samples of the Dirichlet distribution with the given parameters
+ * and calls emit(sample, category, probability) for each of their components.
+ * Sample i only depends on the seed and i, never on the thread drawing it.
+ */
+template<typename Emit>
+void sample_dirichlet(std::span<const double> alphas, std::size_t count, const SamplingOptions &options, Emit emit) {
+    const std::size_t size{alphas.size()};
+    std::vector<GammaSampler> samplers{};
+    samplers.reserve(size);
+    for (std::size_t k = 0; k < size; ++k)
+        samplers.emplace_back(alphas[k], options.seed, static_cast<std::uint32_t>(k));
+
+    double alphaSum{0.0};
+    for (double alpha : alphas)
+        alphaSum += alpha;
+
+    parallel_samples(count, options.threads, [&](std::size_t begin, std::size_t end) {
+        // Gammas of one batch, category major, so that each sampler fills a contiguous run.
+        std::vector<double> gammas(size * sampling_batch_size);
+        for (std::size_t batch = begin; batch < end; batch += sampling_batch_size) {
+            std::size_t lanes{std::min(sampling_batch_size, end - batch)};
+            for (std::size_t k = 0; k < size; ++k)
+                samplers[k](batch, std::span(gammas).subspan(k * sampling_batch_size, lanes));
+
+            for (std::size_t j = 0; j < lanes; ++j) {
+                double sum{0.0};
+                for (std::size_t k = 0; k < size; ++k)
+                    sum += gammas[k * sampling_batch_size + j];
+
+                for (std::size_t k = 0; k < size; ++k) {
+                    // All gammas may underflow for tiny parameters, fall back to the mean then.
+                    emit(batch + j, k, sum > 0.0 ? gammas[k * sampling_batch_size + j] / sum : alphas[k] / alphaSum);
+                }
+            }
+        }
+    });
+}
+
+template<plain_floating_point F>
+[[nodiscard]] constexpr double dirichlet_alpha(F belief, F uncertainty, F apriori, double priorWeight) noexcept {
+    return priorWeight * static_cast<double>(belief) / static_cast<double>(uncertainty)
+           + priorWeight * static_cast<double>(apriori);
+}
+
+/*
+ * Draws samples of the Dirichlet distribution of the opinion into out, one row
+ * of opinion.size() probabilities per sample. Dogmatic opinions, i.e. without
+ * uncertainty, have all their mass on the beliefs, so every row equals them.
+ */
+template<plain_floating_point F, std::size_t N>
+void sample_dirichlet(const MultinomialOpinion<F, N> &opinion, std::span<F> out, const SamplingOptions &options = {}) {
+    if (!(options.priorWeight > 0.0))
+        throw std::invalid_argument("The prior weight must be positive.");
+
+    auto beliefs{opinion.getBeliefs()};
+    if (opinion.getUncertainty() == F(0)) {
+        if (out.size() % beliefs.size() != 0)
+            throw std::invalid_argument("Output must hold whole samples.");
+
+        for (std::size_t row = 0; row < out.size(); row += beliefs.size())
+            std::ranges::copy(beliefs, out.begin() + static_cast<std::ptrdiff_t>(row));
+
+        return;
+    }
+
+    auto apriories{opinion.getApriories()};
+    std::vector<double> alphas(beliefs.size());
+    for (std::size_t k = 0; k < alphas.size(); ++k)
+        alphas[k] = dirichlet_alpha(beliefs[k], opinion.getUncertainty(), apriories[k], options.priorWeight);
+
+    if (out.size() % alphas.size() != 0)
+        throw std::invalid_argument("Output must hold whole samples.");
+
+    sample_dirichlet(alphas, out.size() / alphas.size(), options,
+                     [out, size = alphas.size()](std::size_t sample, std::size_t category, double probability) {
+                         out[sample * size + category] = static_cast<F>(probability);
+                     });
+}
+
+// Draws out.size() samples of the probability of the Beta distribution of the opinion.
+template<plain_floating_point F>
+void sample_beta(const BinomialOpinion<F> &opinion, std::span<F> out, const SamplingOptions &options = {}) {
+    if (!(options.priorWeight > 0.0))
+        throw std::invalid_argument("The prior weight must be positive.");
+
+    if (opinion.getUncertainty() == F(0)) {
+        std::ranges::fill(out, opinion.getBelief());
+        return;
+    }
+
+    const std::array alphas{
+            dirichlet_alpha(opinion.getBelief(), opinion.getUncertainty(), opinion.getApriori(), options.priorWeight),
+            dirichlet_alpha(opinion.getDisbelief(), opinion.getUncertainty(), F(1) - opinion.getApriori(), options.priorWeight)};
+
+    sample_dirichlet(alphas, out.size(), options, [out](std::size_t sample, std::size_t category, double probability) {
+        if (category == 0)
+            out[sample] = static_cast<F>(probability);
+    });
+}
+
+#endif
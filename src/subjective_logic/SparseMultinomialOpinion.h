@@ -0,0 +1,181 @@
+#ifndef CPPPLAYGROUND_SPARSEMULTINOMIALOPINION_H
+#define CPPPLAYGROUND_SPARSEMULTINOMIALOPINION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "floatingPointHelper.h"
+#include "../instrumentation/ScopeCounters.h"
+
+/*
+ * Multinomial opinion over domains with many categories, most of which have
+ * no belief mass. Only the non-zero beliefs are stored as (index, mass) pairs
+ * sorted by index, so construction and the operations on it run in the number
+ * of non-zero beliefs rather than in the size of the domain.
+ *
+ * The apriories are either uniform or a base rate vector shared between all
+ * opinions over the same domain. The shared vector is verified once, when
+ * creating the BaseRates, and not again for every opinion.
+ */
+
+template<plain_floating_point F>
+struct SparseBelief final {
+    std::size_t index;
+    F mass;
+
+    [[nodiscard]] constexpr bool operator==(const SparseBelief &) const noexcept = default;
+};
+
+template<plain_floating_point F>
+class BaseRates final {
+public:
+    [[nodiscard]] static BaseRates uniform(std::size_t size) {
+        if (size < 2)
+            throw std::invalid_argument("Require a size of at least 2.");
+
+        return BaseRates{size, nullptr};
+    }
+
+    [[nodiscard]] static BaseRates shared(std::shared_ptr<const std::vector<F>> rates) {
+        if (!rates)
+            throw std::invalid_argument("Shared base rates must not be null.");
+
+        if (rates->size() < 2)
+            throw std::invalid_argument("Require a size of at least 2.");
+
+        if (!std::ranges::all_of(*rates, is_between_zero_and_one_inclusive<F>))
+            throw std::invalid_argument("Base rates must be between zero and one.");
+
+        std::size_t size{rates->size()};
+        F sum{0};
+        for (F rate : *rates)
+            sum += rate;
+
+        if (!is_approx_one(sum, size))
+            throw std::invalid_argument("Base rates must sum up to one.");
+
+        return BaseRates{size, std::move(rates)};
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return domainSize;
+    }
+
+    [[nodiscard]] constexpr bool isUniform() const noexcept {
+        return rates == nullptr;
+    }
+
+    // Requires index < size().
+    [[nodiscard]] constexpr F operator[](std::size_t index) const noexcept {
+        return isUniform() ? F(1) / static_cast<F>(domainSize) : (*rates)[index];
+    }
+
+    // Whether both describe the same base rates without comparing the vectors:
+    // Uniform base rates of the same size or the very same shared vector.
+    [[nodiscard]] constexpr bool sharesWith(const BaseRates &other) const noexcept {
+        return domainSize == other.domainSize && rates == other.rates;
+    }
+
+private:
+    [[nodiscard]] BaseRates(std::size_t size, std::shared_ptr<const std::vector<F>> rates) noexcept
+        : domainSize{size}, rates{std::move(rates)} {}
+
+    std::size_t domainSize;
+    // nullptr for uniform base rates.
+    std::shared_ptr<const std::vector<F>> rates;
+};
+
+template<plain_floating_point F>
+class SparseMultinomialOpinion final {
+public:
+    // Beliefs must be sorted by strictly increasing index. Zero masses are dropped.
+    [[nodiscard]] SparseMultinomialOpinion(std::vector<SparseBelief<F>> beliefs, F uncertainty, BaseRates<F> baseRates)
+        : beliefs{std::move(beliefs)}, uncertainty{uncertainty}, baseRates{std::move(baseRates)} {
+        CPPPLAYGROUND_SCOPE_COUNTERS("SparseMultinomialOpinion()");
+        std::erase_if(this->beliefs, [](const SparseBelief<F> &belief) { return belief.mass == F(0); });
+        if (!verifySelf())
+            throw std::invalid_argument("Invariant for sparse multinomial opinion does not hold.");
+    }
+
+    [[nodiscard]] std::span<const SparseBelief<F>> getBeliefs() const noexcept {
+        return beliefs;
+    }
+
+    // Requires index < size(). Runs in O(log nonZeroCount()).
+    [[nodiscard]] F getBelief(std::size_t index) const noexcept {
+        auto it{std::ranges::lower_bound(beliefs, index, {}, &SparseBelief<F>::index)};
+        return it != beliefs.end() && it->index == index ? it->mass : F(0);
+    }
+
+    [[nodiscard]] constexpr F getUncertainty() const noexcept {
+        return uncertainty;
+    }
+
+    [[nodiscard]] constexpr const BaseRates<F> &getBaseRates() const noexcept {
+        return baseRates;
+    }
+
+    // Requires index < size().
+    [[nodiscard]] constexpr F getApriori(std::size_t index) const noexcept {
+        return baseRates[index];
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return baseRates.size();
+    }
+
+    [[nodiscard]] constexpr std::size_t nonZeroCount() const noexcept {
+        return beliefs.size();
+    }
+
+private:
+    [[nodiscard]] bool verifySelf() const noexcept {
+        if (!is_between_zero_and_one_inclusive(uncertainty))
+            return false;
+
+        F sum{0};
+        for (std::size_t i = 0; i < beliefs.size(); ++i) {
+            const auto &[index, mass] {beliefs[i]};
+            if (index >= size() || (i > 0 && beliefs[i - 1].index >= index))
+                return false;
+
+            if (!is_between_zero_and_one_inclusive(mass))
+                return false;
+
+            sum += mass;
+        }
+
+        return is_approx_one(sum + uncertainty, beliefs.size() + 1);
+    }
+
+    std::vector<SparseBelief<F>> beliefs;
+    F uncertainty;
+    BaseRates<F> baseRates;
+};
+
+template<plain_floating_point F>
+std::ostream &operator<<(std::ostream &os, const SparseMultinomialOpinion<F> &opinion) {
+    os << "SparseMultinomialOpinion{size: " << opinion.size() << ", beliefs: [";
+    bool first{true};
+    for (const auto &[index, mass] : opinion.getBeliefs()) {
+        os << (first ? "" : ", ") << index << ": " << mass;
+        first = false;
+    }
+
+    os << "], uncertainty: " << opinion.getUncertainty() << ", apriories: ";
+    if (opinion.getBaseRates().isUniform()) {
+        os << "uniform";
+    } else {
+        os << "shared";
+    }
+
+    return (os << "}");
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef CPPPLAYGROUND_UNCHECKED_H
+#define CPPPLAYGROUND_UNCHECKED_H
+
+/*
+ * Selects the constructors of opinions that skip the validation. Only meant
+ * for producers that guarantee the invariant themselves, like the operations
+ * in Operations.h. Use find_invalid_opinions() from Validation.h to check
+ * opinions created this way from data that is not fully trusted.
+ */
+struct unchecked_t final {
+    explicit unchecked_t() = default;
+};
+
+inline constexpr unchecked_t unchecked{};
+
+#endif
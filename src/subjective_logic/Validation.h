@@ -0,0 +1,71 @@
+#ifndef CPPPLAYGROUND_VALIDATION_H
+#define CPPPLAYGROUND_VALIDATION_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "BinomialOpinion.h"
+#include "MultinomialOpinion.h"
+
+/*
+ * Validation of whole arrays of opinions, e.g. ones created using the
+ * unchecked constructors from data that is not fully trusted.
+ *
+ * The opinions are checked in blocks: First the validity of every opinion in
+ * the block is computed into a mask without any branches, which the compiler
+ * turns into SIMD comparisons and reductions. Only then are the indices of
+ * the invalid opinions collected, which is rare and thus cheap.
+ * Nothing is allocated and nothing is thrown.
+ */
+
+template<typename Opinion>
+concept validatable_opinion = requires(const Opinion &opinion) {
+    { opinion.isValid() } -> std::same_as<bool>;
+};
+
+/*
+ * Writes the indices of the invalid opinions into invalid, in increasing
+ * order, and returns how many opinions are invalid. If that is more than
+ * invalid.size(), only the first invalid.size() indices are written.
+ */
+template<validatable_opinion Opinion>
+[[nodiscard]] std::size_t find_invalid_opinions(std::span<const Opinion> opinions,
+                                                std::span<std::size_t> invalid) noexcept {
+    constexpr std::size_t blockSize{256};
+    std::array<std::uint8_t, blockSize> valid{};
+    std::size_t count{0};
+    for (std::size_t offset = 0; offset < opinions.size(); offset += blockSize) {
+        auto block{opinions.subspan(offset, std::min(blockSize, opinions.size() - offset))};
+        for (std::size_t i = 0; i < block.size(); ++i)
+            valid[i] = block[i].isValid();
+
+        // Skips the search in the common case of a fully valid block.
+        std::uint8_t allValid{1};
+        for (std::size_t i = 0; i < block.size(); ++i)
+            allValid &= valid[i];
+
+        if (allValid)
+            continue;
+
+        for (std::size_t i = 0; i < block.size(); ++i) {
+            if (!valid[i]) {
+                if (count < invalid.size())
+                    invalid[count] = offset + i;
+
+                ++count;
+            }
+        }
+    }
+
+    return count;
+}
+
+template<validatable_opinion Opinion>
+[[nodiscard]] bool all_valid(std::span<const Opinion> opinions) noexcept {
+    return find_invalid_opinions(opinions, std::span<std::size_t>{}) == 0;
+}
+
+#endif
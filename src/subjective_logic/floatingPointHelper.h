@@ -2,19 +2,23 @@
 #define CPPPLAYGROUND_FLOATINGPOINTHELPER_H
 
 #include<concepts>
+#include<cstddef>
 #include<numeric>
 
 template<typename F>
 concept plain_floating_point = std::floating_point<F> && !std::is_const_v<F> && !std::is_volatile_v<F>;
 
+// Tolerates the rounding error of every addition in a sum of the given number
+// of terms, so that sums over large domains are not rejected.
 template<plain_floating_point F>
-[[nodiscard]] constexpr bool is_approx_one(F x) noexcept {
-    auto epsilon{std::numeric_limits<F>::epsilon()};
-    return x >= 1.0 && (x - 1.0) <= epsilon || x < 1.0 && x + epsilon >= 1.0;
+[[nodiscard]] constexpr bool is_approx_one(F x, std::size_t terms = 1) noexcept {
+    auto epsilon{std::numeric_limits<F>::epsilon() * static_cast<F>(terms > 1 ? terms : 1)};
+    // Bitwise operators instead of logical ones keep this free of branches.
+    return ((x >= F(1)) & ((x - F(1)) <= epsilon)) | ((x < F(1)) & (x + epsilon >= F(1)));
 }
 
 template<plain_floating_point F>
 [[nodiscard]] inline constexpr bool is_between_zero_and_one_inclusive(F x) noexcept {
-    return x >= 0.0 && x <= 1.0;
+    return (x >= F(0)) & (x <= F(1));
 }
 #endif
@@ -0,0 +1,175 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/activation/activations.h"
+#include "../src/activation/quantization.h"
+
+constexpr std::array all_isas{Isa::Scalar, Isa::Sse41, Isa::Avx2, Isa::Avx512};
+
+template<activation_type T>
+[[nodiscard]] std::vector<T> interesting_values(std::size_t size) {
+    std::vector<T> values(size);
+    for (std::size_t i = 0; i < size; ++i)
+        values[i] = static_cast<T>(static_cast<int>(i % 23) - 11);
+
+    if constexpr (std::floating_point<T>) {
+        values[1] = -T(0);
+        values[2] = std::numeric_limits<T>::quiet_NaN();
+        values[3] = -std::numeric_limits<T>::infinity();
+        values[4] = T(6.5);
+    } else {
+        values[1] = std::numeric_limits<T>::min();
+        values[2] = std::numeric_limits<T>::max();
+    }
+
+    return values;
+}
+
+template<typename T>
+[[nodiscard]] bool bitwise_equal(std::span<const T> lhs, std::span<const T> rhs) {
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size_bytes()) == 0;
+}
+
+/*
+ * Runs the kernel for every supported instruction set on odd sizes and
+ * unaligned offsets, so that heads, vector bodies and tails are all exercised,
+ * and compares the results bitwise against the scalar kernel.
+ */
+template<activation_type T, typename U, typename Kernel>
+void testMatchesScalar(Kernel kernel) {
+    constexpr std::size_t size{203};
+    const std::vector<T> input{interesting_values<T>(size + 3)};
+
+    for (std::size_t offset : {0, 1, 3}) {
+        for (std::size_t count : {0, 1, 7, 64, 200}) {
+            std::span<const T> in{std::span(input).subspan(offset, count)};
+            std::vector<U> expected(count + 3);
+            kernel(in, std::span(expected).subspan(offset, count), Isa::Scalar);
+
+            for (Isa isa : all_isas) {
+                if (!is_supported(isa))
+                    continue;
+
+                std::vector<U> actual(count + 3);
+                kernel(in, std::span(actual).subspan(offset, count), isa);
+                EXPECT_TRUE(bitwise_equal<U>(std::span(expected).subspan(offset, count),
+                                             std::span(actual).subspan(offset, count)))
+                        << to_string(isa) << ", offset " << offset << ", count " << count;
+            }
+        }
+    }
+}
+
+template<activation_type T>
+void testAllKernelsMatchScalar() {
+    testMatchesScalar<T, T>([](auto in, auto out, Isa isa) { relu(in, out, isa); });
+    testMatchesScalar<T, T>([](auto in, auto out, Isa isa) { relu6(in, out, isa); });
+    testMatchesScalar<T, sign_mask_t<T>>([](auto in, auto out, Isa isa) { sign_mask(in, out, isa); });
+    if constexpr (std::floating_point<T>)
+        testMatchesScalar<T, T>([](auto in, auto out, Isa isa) { leaky_relu(in, out, T(0.1), isa); });
+}
+
+TEST(Activations, FloatMatchesScalar) {
+    testAllKernelsMatchScalar<float>();
+}
+
+TEST(Activations, DoubleMatchesScalar) {
+    testAllKernelsMatchScalar<double>();
+}
+
+TEST(Activations, Int8MatchesScalar) {
+    testAllKernelsMatchScalar<std::int8_t>();
+}
+
+TEST(Activations, Int16MatchesScalar) {
+    testAllKernelsMatchScalar<std::int16_t>();
+}
+
+TEST(Activations, Int32MatchesScalar) {
+    testAllKernelsMatchScalar<std::int32_t>();
+}
+
+TEST(Activations, ScalarResults) {
+    const std::array input{-2.0f, -0.5f, 0.0f, 3.0f, 8.0f};
+    std::array<float, 5> output{};
+
+    relu(std::span<const float>(input), std::span(output), Isa::Scalar);
+    EXPECT_THAT(output, testing::ElementsAre(0.0f, 0.0f, 0.0f, 3.0f, 8.0f));
+
+    relu6(std::span<const float>(input), std::span(output), Isa::Scalar);
+    EXPECT_THAT(output, testing::ElementsAre(0.0f, 0.0f, 0.0f, 3.0f, 6.0f));
+
+    leaky_relu(std::span<const float>(input), std::span(output), 0.5f, Isa::Scalar);
+    EXPECT_THAT(output, testing::ElementsAre(-1.0f, -0.25f, 0.0f, 3.0f, 8.0f));
+
+    std::array<std::int32_t, 5> masks{};
+    sign_mask(std::span<const float>(input), std::span(masks), Isa::Scalar);
+    EXPECT_THAT(masks, testing::ElementsAre(-1, -1, 0, 0, 0));
+}
+
+TEST(Activations, DifferentSizesThrow) {
+    std::array<float, 3> input{};
+    std::array<float, 2> output{};
+    EXPECT_THROW(relu(std::span<const float>(input), std::span(output)), std::invalid_argument);
+}
+
+TEST(Activations, InvalidParametersThrow) {
+    std::array<float, 3> input{};
+    std::array<float, 3> output{};
+    EXPECT_THROW(clipped_relu(std::span<const float>(input), std::span(output), -1.0f), std::invalid_argument);
+    EXPECT_THROW(leaky_relu(std::span<const float>(input), std::span(output), 2.0f), std::invalid_argument);
+}
+
+TEST(ReluQuantize, ScalarResults) {
+    const std::array input{-2.0f, 0.0f, 0.75f, 1.25f, 1.5f, 2.5f, 100.0f, 1e30f,
+                           std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()};
+    std::array<std::int8_t, 10> output{};
+    relu_quantize(std::span(input), std::span(output), 2.0f, {.isa = Isa::Scalar});
+    EXPECT_THAT(output, testing::ElementsAre(0, 0, 2, 2, 3, 5, 127, 127, 0, 127));
+}
+
+TEST(ReluQuantize, MatchesScalar) {
+    // Large enough to be split across three threads.
+    std::vector<float> input(200'000);
+    for (std::size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<float>(static_cast<int>(i % 401) - 150) * 0.25f;
+
+    input[5] = std::numeric_limits<float>::quiet_NaN();
+    input[6] = -0.0f;
+    input[7] = std::numeric_limits<float>::infinity();
+
+    for (std::size_t offset : {0, 1, 5}) {
+        std::span<const float> in{std::span(input).subspan(offset, input.size() - 8)};
+        std::vector<std::int8_t> expected(input.size());
+        relu_quantize(in, std::span(expected).subspan(offset, in.size()), 0.7f, {.isa = Isa::Scalar});
+
+        for (Isa isa : all_isas) {
+            if (!is_supported(isa))
+                continue;
+
+            for (bool nonTemporal : {false, true}) {
+                for (std::size_t threads : {1, 3}) {
+                    std::vector<std::int8_t> actual(input.size());
+                    relu_quantize(in, std::span(actual).subspan(offset, in.size()), 0.7f,
+                                  {.isa = isa, .threads = threads, .nonTemporalStores = nonTemporal});
+                    EXPECT_EQ(expected, actual) << to_string(isa) << ", offset " << offset
+                                                << ", non-temporal " << nonTemporal << ", threads " << threads;
+                }
+            }
+        }
+    }
+}
+
+TEST(ReluQuantize, InvalidScaleThrows) {
+    std::array<float, 3> input{};
+    std::array<std::int8_t, 3> output{};
+    EXPECT_THROW(relu_quantize(std::span<const float>(input), std::span(output), 0.0f), std::invalid_argument);
+    EXPECT_THROW(relu_quantize(std::span<const float>(input), std::span(output), std::numeric_limits<float>::infinity()), std::invalid_argument);
+}
@@ -0,0 +1,95 @@
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/BatchOperations.h"
+
+namespace {
+    std::vector<MultinomialOpinion<double, 3>> static_opinions(std::size_t count) {
+        std::vector<MultinomialOpinion<double, 3>> opinions{};
+        opinions.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            double belief{static_cast<double>(i % 10) / 20.0};
+            std::array beliefs {belief, 0.25, 0.0};
+            std::array apriories {0.2, 0.3, 0.5};
+            opinions.emplace_back(std::span(beliefs), 0.75 - belief, std::span(apriories));
+        }
+
+        return opinions;
+    }
+}
+
+TEST(BatchOperations, CoarsenMatchesSequential) {
+    ThreadPool pool{3};
+    auto opinions{static_opinions(5000)};
+    std::vector<BinomialOpinion<double>> out(opinions.size(), BinomialOpinion<double>{0.0, 0.0, 1.0, 0.5});
+    coarsen_batch(std::span<const MultinomialOpinion<double, 3>>{opinions}, 1, std::span(out), pool);
+
+    for (std::size_t i = 0; i < opinions.size(); ++i) {
+        auto expected{coarsen(opinions[i], 1)};
+        EXPECT_EQ(out[i].getBelief(), expected.getBelief());
+        EXPECT_EQ(out[i].getDisbelief(), expected.getDisbelief());
+        EXPECT_EQ(out[i].getUncertainty(), expected.getUncertainty());
+        EXPECT_EQ(out[i].getApriori(), expected.getApriori());
+    }
+
+    EXPECT_THROW(coarsen_batch(std::span<const MultinomialOpinion<double, 3>>{opinions}, 3, std::span(out), pool),
+                 std::invalid_argument);
+    EXPECT_THROW(coarsen_batch(std::span<const MultinomialOpinion<double, 3>>{opinions}, 0, std::span(out).first(10), pool),
+                 std::invalid_argument);
+}
+
+TEST(BatchOperations, ConvertsBetweenStaticAndDynamic) {
+    ThreadPool pool{2};
+    auto opinions{static_opinions(1000)};
+    std::array beliefs {0.0, 0.0, 0.0};
+    std::array apriories {0.2, 0.3, 0.5};
+    std::vector<MultinomialOpinion<double, std::dynamic_extent>> dynamic{};
+    std::vector<MultinomialOpinion<double, 3>> roundTrip{};
+    for (std::size_t i = 0; i < opinions.size(); ++i) {
+        dynamic.emplace_back(std::span(beliefs), 1.0, std::span(apriories));
+        roundTrip.emplace_back(std::span(beliefs), 1.0, std::span(apriories));
+    }
+
+    make_dynamic_batch(std::span<const MultinomialOpinion<double, 3>>{opinions}, std::span(dynamic), pool);
+
+    make_static_batch<double, 3>(std::span<const MultinomialOpinion<double, std::dynamic_extent>>{dynamic}, std::span(roundTrip), pool);
+
+    for (std::size_t i = 0; i < opinions.size(); ++i) {
+        EXPECT_TRUE(std::ranges::equal(dynamic[i].getBeliefs(), opinions[i].getBeliefs()));
+        EXPECT_TRUE(std::ranges::equal(roundTrip[i].getBeliefs(), opinions[i].getBeliefs()));
+        EXPECT_EQ(roundTrip[i].getUncertainty(), opinions[i].getUncertainty());
+    }
+
+    std::array wideBeliefs {0.25, 0.25};
+    std::array wideApriories {0.5, 0.5};
+    dynamic[500] = MultinomialOpinion<double, std::dynamic_extent>{std::span(wideBeliefs), 0.5, std::span(wideApriories)};
+    EXPECT_THROW((make_static_batch<double, 3>(std::span<const MultinomialOpinion<double, std::dynamic_extent>>{dynamic},
+                                               std::span(roundTrip), pool)), std::invalid_argument);
+    EXPECT_THROW(coarsen_batch(std::span<const MultinomialOpinion<double, std::dynamic_extent>>{dynamic}, 2,
+                               std::span<BinomialOpinion<double>>{}, pool), std::invalid_argument);
+}
+
+TEST(BatchOperations, FindsInvalidOpinionsInOrder) {
+    ThreadPool pool{3};
+    std::vector<BinomialOpinion<float>> opinions(20'000, BinomialOpinion<float>{0.25f, 0.25f, 0.5f, 0.5f});
+    for (std::size_t i : std::array<std::size_t, 4>{7, 4'000, 4'001, 19'999})
+        opinions[i] = BinomialOpinion<float>{unchecked, 0.5f, 0.5f, 0.5f, 0.5f};
+
+    std::span<const BinomialOpinion<float>> all{opinions};
+    std::array<std::size_t, 8> invalid{};
+    std::size_t count{find_invalid_opinions_batch(all, std::span(invalid), pool)};
+    ASSERT_EQ(count, 4);
+    EXPECT_THAT(std::span(invalid).first(count), testing::ElementsAre(7, 4'000, 4'001, 19'999));
+
+    std::array<std::size_t, 2> two{};
+    EXPECT_EQ(find_invalid_opinions_batch(all, std::span(two), pool), 4);
+    EXPECT_THAT(two, testing::ElementsAre(7, 4'000));
+
+    EXPECT_FALSE(all_valid_batch(all, pool));
+    EXPECT_TRUE(all_valid_batch(all.subspan(8, 3'000), pool));
+}
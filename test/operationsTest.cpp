@@ -0,0 +1,58 @@
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/Operations.h"
+
+TEST(Coarsen, CoarsenToCategory) {
+    std::array beliefs {0.1, 0.2, 0.3};
+    std::array apriories {0.2, 0.3, 0.5};
+    MultinomialOpinion<double, 3> opinion{std::span(beliefs), 0.4, std::span(apriories)};
+
+    BinomialOpinion<double> coarsened{coarsen(opinion, 2)};
+    EXPECT_EQ(coarsened.getBelief(), 0.3);
+    EXPECT_DOUBLE_EQ(coarsened.getDisbelief(), 0.3);
+    EXPECT_EQ(coarsened.getUncertainty(), 0.4);
+    EXPECT_EQ(coarsened.getApriori(), 0.5);
+}
+
+TEST(Coarsen, BeliefAtEdgeOfTolerance) {
+    // The beliefs and the uncertainty sum up to 1 + 5 epsilon, the most a size of 4 allows.
+    constexpr float epsilon{std::numeric_limits<float>::epsilon()};
+    std::array beliefs {0.5f + 3 * epsilon, 0.0f, 0.0f, 0.0f};
+    std::array apriories {0.25f, 0.25f, 0.25f, 0.25f};
+    MultinomialOpinion<float, 4> opinion{std::span(beliefs), 0.5f + 2 * epsilon, std::span(apriories)};
+
+    BinomialOpinion<float> coarsened{coarsen(opinion, 0)};
+    EXPECT_TRUE(coarsened.isValid());
+    EXPECT_EQ(coarsened.getBelief(), 1.0f - opinion.getUncertainty());
+    EXPECT_EQ(coarsened.getDisbelief(), 0.0f);
+    EXPECT_NO_THROW((BinomialOpinion<float>{coarsened.getBelief(), coarsened.getDisbelief(),
+                                            coarsened.getUncertainty(), coarsened.getApriori()}));
+
+    SparseMultinomialOpinion<float> sparse{{{1, 0.5f + epsilon}}, 0.5f + epsilon, BaseRates<float>::uniform(1000)};
+    EXPECT_TRUE(coarsen(sparse, 1).isValid());
+}
+
+TEST(Coarsen, CoarsenOutOfRangeThrows) {
+    std::array beliefs {0.5, 0.5};
+    std::array apriories {0.5, 0.5};
+    MultinomialOpinion<double, std::dynamic_extent> opinion{std::span(beliefs), 0.0, std::span(apriories)};
+    EXPECT_THROW(std::ignore = coarsen(opinion, 2), std::invalid_argument);
+}
+
+TEST(Conversion, MakeStaticAndDynamic) {
+    std::array beliefs {0.5, 0.25};
+    std::array apriories {0.5, 0.5};
+    MultinomialOpinion<double, std::dynamic_extent> dynamic{std::span(beliefs), 0.25, std::span(apriories)};
+
+    MultinomialOpinion<double, 2> fixed{make_static<double, 2>(dynamic)};
+    EXPECT_TRUE(std::ranges::equal(fixed.getBeliefs(), beliefs));
+    EXPECT_TRUE(std::ranges::equal(make_dynamic(fixed).getApriories(), apriories));
+    EXPECT_THROW(std::ignore = (make_static<double, 3>(dynamic)), std::invalid_argument);
+}
@@ -0,0 +1,94 @@
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/OpinionGraph.h"
+#include "../src/subjective_logic/Operations.h"
+
+using DynamicOpinion = MultinomialOpinion<double, std::dynamic_extent>;
+
+DynamicOpinion make_opinion(std::vector<double> beliefs, double uncertainty) {
+    std::vector<double> apriories(beliefs.size(), 1.0 / static_cast<double>(beliefs.size()));
+    return DynamicOpinion{std::span<const double>{beliefs}, uncertainty, std::span<const double>{apriories}};
+}
+
+TEST(OpinionGraph, DerivedNodesAreComputedLazily) {
+    OpinionGraph graph{};
+    auto opinion{graph.input(make_opinion({0.25, 0.5}, 0.25))};
+    auto coarsened{graph.derive([](const DynamicOpinion &o) { return coarsen(o, 1); }, opinion)};
+
+    EXPECT_TRUE(graph.isDirty(coarsened));
+    EXPECT_EQ(graph.recomputations(), 0);
+    EXPECT_EQ(graph.get(coarsened).getBelief(), 0.5);
+    EXPECT_EQ(graph.get(coarsened).getBelief(), 0.5);
+    EXPECT_EQ(graph.recomputations(), 1);
+
+    graph.set(opinion, make_opinion({0.5, 0.25}, 0.25));
+    EXPECT_TRUE(graph.isDirty(coarsened));
+    EXPECT_EQ(graph.get(coarsened).getBelief(), 0.25);
+    EXPECT_EQ(graph.recomputations(), 2);
+}
+
+TEST(OpinionGraph, UpdateOnlyRecomputesDownstream) {
+    OpinionGraph graph{};
+    std::vector<OpinionGraph::InputNode<double>> leaves{};
+    std::vector<OpinionGraph::Node<double>> derived{};
+    for (int i = 0; i < 10; ++i) {
+        leaves.push_back(graph.input(static_cast<double>(i)));
+        derived.push_back(graph.derive([](double x) { return 2 * x; }, leaves.back()));
+    }
+
+    graph.refresh();
+    EXPECT_EQ(graph.recomputations(), 10);
+
+    graph.set(leaves[3], 10.0);
+    EXPECT_TRUE(graph.isDirty(derived[3]));
+    EXPECT_FALSE(graph.isDirty(derived[4]));
+    EXPECT_EQ(graph.get(derived[3]), 20.0);
+    EXPECT_EQ(graph.recomputations(), 11);
+}
+
+TEST(OpinionGraph, DiamondIsRecomputedOnceInTopologicalOrder) {
+    OpinionGraph graph{};
+    auto leaf{graph.input(1.0)};
+    auto left{graph.derive([](double x) { return x + 1; }, leaf)};
+    auto right{graph.derive([](double x) { return x * 10; }, leaf)};
+    auto sum{graph.derive([](double a, double b) { return a + b; }, left, right)};
+    EXPECT_EQ(graph.get(sum), 12.0);
+    EXPECT_EQ(graph.recomputations(), 3);
+
+    // Several updates are batched into a single recomputation.
+    graph.set(leaf, 2.0);
+    graph.set(leaf, 3.0);
+    EXPECT_EQ(graph.get(sum), 34.0);
+    EXPECT_EQ(graph.recomputations(), 6);
+}
+
+TEST(OpinionGraph, FailedComputationStaysDirty) {
+    OpinionGraph graph{};
+    auto opinion{graph.input(make_opinion({0.25, 0.5}, 0.25))};
+    auto index{graph.input(std::size_t{5})};
+    auto coarsened{graph.derive([](const DynamicOpinion &o, std::size_t to) { return coarsen(o, to); }, opinion, index)};
+
+    EXPECT_THROW(std::ignore = graph.get(coarsened), std::invalid_argument);
+    EXPECT_TRUE(graph.isDirty(coarsened));
+
+    graph.set(index, std::size_t{0});
+    EXPECT_EQ(graph.get(coarsened).getBelief(), 0.25);
+}
+
+TEST(OpinionGraph, InputNodesCanBeRead) {
+    OpinionGraph graph{};
+    auto leaf{graph.input(1.0)};
+    auto doubled{graph.derive([](double x) { return 2 * x; }, leaf)};
+
+    EXPECT_EQ(graph.get(leaf), 1.0);
+    EXPECT_FALSE(graph.isDirty(leaf));
+
+    graph.set(leaf, 2.0);
+    EXPECT_EQ(graph.get(leaf), 2.0);
+    EXPECT_EQ(graph.get(doubled), 4.0);
+}
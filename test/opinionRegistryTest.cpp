@@ -0,0 +1,112 @@
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/BinomialOpinion.h"
+#include "../src/subjective_logic/MultinomialOpinion.h"
+#include "../src/subjective_logic/OpinionRegistry.h"
+
+using DynamicOpinion = MultinomialOpinion<double, std::dynamic_extent>;
+
+DynamicOpinion make_opinion(double uncertainty) {
+    std::vector beliefs {1.0 - uncertainty, 0.0};
+    std::vector apriories {0.5, 0.5};
+    return DynamicOpinion{std::span<const double>{beliefs}, uncertainty, std::span<const double>{apriories}};
+}
+
+TEST(OpinionRegistry, PublishFindAndErase) {
+    OpinionRegistry<DynamicOpinion> registry{4};
+    auto reader{registry.reader()};
+
+    registry.publish(1, make_opinion(0.25));
+    registry.publish(2, make_opinion(0.5));
+    registry.publish(1, make_opinion(0.75));
+    EXPECT_EQ(registry.size(), 2);
+
+    {
+        auto snapshot{reader.snapshot()};
+        ASSERT_NE(snapshot.find(1), nullptr);
+        EXPECT_EQ(snapshot.find(1)->getUncertainty(), 0.75);
+        EXPECT_EQ(snapshot.find(2)->getUncertainty(), 0.5);
+        EXPECT_EQ(snapshot.find(3), nullptr);
+    }
+
+    EXPECT_TRUE(registry.erase(1));
+    EXPECT_FALSE(registry.erase(1));
+    EXPECT_EQ(registry.size(), 1);
+    EXPECT_TRUE(reader.read(1, [](const DynamicOpinion *opinion) { return opinion == nullptr; }));
+}
+
+TEST(OpinionRegistry, SnapshotKeepsOldVersionAlive) {
+    OpinionRegistry<BinomialOpinion<double>> registry{};
+    auto reader{registry.reader()};
+    registry.publish(7, BinomialOpinion<double>{0.5, 0.5, 0.0, 0.5});
+
+    {
+        auto snapshot{reader.snapshot()};
+        const auto *old{snapshot.find(7)};
+        for (int i = 0; i < 100; ++i)
+            registry.publish(7, BinomialOpinion<double>{0.0, 0.5, 0.5, 0.5});
+
+        EXPECT_EQ(old->getBelief(), 0.5);
+        EXPECT_GE(registry.pendingReclamation(), 100);
+    }
+
+    registry.reclaim();
+    registry.reclaim();
+    EXPECT_EQ(registry.pendingReclamation(), 0);
+}
+
+TEST(OpinionRegistry, ReaderSlotsAreLimited) {
+    OpinionRegistry<BinomialOpinion<double>> registry{16, 1};
+    {
+        auto reader{registry.reader()};
+        EXPECT_THROW(std::ignore = registry.reader(), std::length_error);
+    }
+
+    EXPECT_NO_THROW(std::ignore = registry.reader());
+}
+
+TEST(OpinionRegistry, ConcurrentReadersSeeConsistentVersions) {
+    constexpr std::size_t ids{64};
+    OpinionRegistry<BinomialOpinion<double>> registry{ids};
+    for (std::size_t id = 0; id < ids; ++id)
+        registry.publish(id, BinomialOpinion<double>{0.0, 1.0, 0.0, 0.5});
+
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> inconsistent{0};
+    std::vector<std::jthread> readers{};
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            auto reader{registry.reader()};
+            while (!done.load(std::memory_order_relaxed)) {
+                for (std::size_t id = 0; id < ids; ++id) {
+                    reader.read(id, [&](const BinomialOpinion<double> *opinion) {
+                        if (opinion != nullptr && opinion->getBelief() + opinion->getDisbelief() != 1.0)
+                            inconsistent.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 20000; ++i) {
+        std::size_t id{static_cast<std::size_t>(i) % ids};
+        double belief{static_cast<double>(i % 5) / 4};
+        if (i % 7 == 0) {
+            registry.erase(id);
+        } else {
+            registry.publish(id, BinomialOpinion<double>{belief, 1.0 - belief, 0.0, 0.5});
+        }
+    }
+
+    done = true;
+    readers.clear();
+    EXPECT_EQ(inconsistent.load(), 0);
+}
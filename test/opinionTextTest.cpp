@@ -0,0 +1,118 @@
+#include <array>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/OpinionText.h"
+
+TEST(OpinionText, FormatBinomial) {
+    BinomialOpinion<double> opinion{0.7, 0.2, 0.1, 0.5};
+    std::array<char, 64> buffer{};
+    auto [ptr, ec] {format_opinion(buffer.data(), buffer.data() + buffer.size(), opinion)};
+    ASSERT_EQ(ec, std::errc{});
+    EXPECT_EQ(std::string_view(buffer.data(), ptr), "0.7 0.2 0.1 0.5");
+}
+
+TEST(OpinionText, FormatMultinomial) {
+    std::array beliefs {0.25, 0.5};
+    std::array apriories {0.5, 0.5};
+    MultinomialOpinion<double, 2> opinion{std::span(beliefs), 0.25, std::span(apriories)};
+    std::string out{};
+    format_opinions(std::span{&opinion, 1}, out);
+    EXPECT_EQ(out, "0.25 0.25 0.5 0.5 0.5\n");
+}
+
+TEST(OpinionText, BufferTooSmall) {
+    BinomialOpinion<double> opinion{0.7, 0.2, 0.1, 0.5};
+    std::array<char, 8> buffer{};
+    auto [ptr, ec] {format_opinion(buffer.data(), buffer.data() + buffer.size(), opinion)};
+    EXPECT_EQ(ec, std::errc::value_too_large);
+}
+
+TEST(OpinionText, ParseBinomial) {
+    std::string_view text{"  0.7\t0.2 0.1 0.5\n"};
+    auto [ptr, ec, opinion] {parse_binomial<double>(text.data(), text.data() + text.size())};
+    ASSERT_EQ(ec, std::errc{});
+    EXPECT_EQ(*ptr, '\n');
+    EXPECT_EQ(opinion->getBelief(), 0.7);
+    EXPECT_EQ(opinion->getApriori(), 0.5);
+}
+
+TEST(OpinionText, ParseMalformed) {
+    for (std::string_view text : {"0.7 0.2 0.1", "0.7 0.2x 0.1 0.5", "a 0.2 0.1 0.5"}) {
+        auto [ptr, ec, opinion] {parse_binomial<double>(text.data(), text.data() + text.size())};
+        EXPECT_NE(ec, std::errc{}) << text;
+        EXPECT_FALSE(opinion.has_value()) << text;
+    }
+
+    std::string_view even{"0.1 0.5 0.4 0.5"};
+    auto [ptr, ec, opinion] {parse_multinomial<double, std::dynamic_extent>(even.data(), even.data() + even.size())};
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+}
+
+TEST(OpinionText, ParseInvalidOpinionThrows) {
+    std::string_view text{"0.7 0.8 0.9 0.8"};
+    EXPECT_THROW(std::ignore = parse_binomial<double>(text.data(), text.data() + text.size()), std::invalid_argument);
+}
+
+template<plain_floating_point F>
+void testRoundTrip() {
+    std::mt19937 generator{7};
+    std::uniform_real_distribution<F> distribution{F(0), F(1)};
+
+    std::vector<MultinomialOpinion<F, 3>> opinions{};
+    for (int i = 0; i < 1000; ++i) {
+        std::array<F, 3> beliefs{distribution(generator) / 4, distribution(generator) / 4, distribution(generator) / 4};
+        F uncertainty{F(1) - beliefs[0] - beliefs[1] - beliefs[2]};
+        std::array<F, 3> apriories{F(0.25), F(0.25), F(0.5)};
+        opinions.emplace_back(std::span<const F, 3>(beliefs), uncertainty, std::span<const F, 3>(apriories));
+    }
+
+    std::string text{};
+    format_opinions(opinions, text);
+
+    std::vector<MultinomialOpinion<F, 3>> parsedStatic{};
+    ASSERT_EQ(parse_opinions(text, parsedStatic).ec, std::errc{});
+    std::vector<MultinomialOpinion<F, std::dynamic_extent>> parsedDynamic{};
+    ASSERT_EQ(parse_opinions(text, parsedDynamic).ec, std::errc{});
+
+    ASSERT_EQ(parsedStatic.size(), opinions.size());
+    ASSERT_EQ(parsedDynamic.size(), opinions.size());
+    for (std::size_t i = 0; i < opinions.size(); ++i) {
+        EXPECT_TRUE(std::ranges::equal(opinions[i].getBeliefs(), parsedStatic[i].getBeliefs()));
+        EXPECT_TRUE(std::ranges::equal(opinions[i].getBeliefs(), parsedDynamic[i].getBeliefs()));
+        EXPECT_EQ(opinions[i].getUncertainty(), parsedStatic[i].getUncertainty());
+        EXPECT_TRUE(std::ranges::equal(opinions[i].getApriories(), parsedDynamic[i].getApriories()));
+    }
+}
+
+TEST(OpinionText, RoundTripFloat) {
+    testRoundTrip<float>();
+}
+
+TEST(OpinionText, RoundTripDouble) {
+    testRoundTrip<double>();
+}
+
+TEST(OpinionText, BatchSkipsEmptyLines) {
+    std::vector<BinomialOpinion<double>> opinions{};
+    auto [ptr, ec] {parse_opinions(std::string_view{"\n1 0 0 1\r\n\n  \n0 1 0 0"}, opinions)};
+    ASSERT_EQ(ec, std::errc{});
+    EXPECT_EQ(opinions.size(), 2);
+}
+
+TEST(OpinionText, StreamMultinomial) {
+    std::array beliefs {0.25, 0.5};
+    std::array apriories {0.5, 0.5};
+    MultinomialOpinion<double, std::dynamic_extent> opinion{std::span(beliefs), 0.25, std::span(apriories)};
+    std::ostringstream os{};
+    os << opinion;
+    EXPECT_EQ(os.str(), "MultinomialOpinion{size: 2, isDynamicSized: 1, beliefs: [0.25, 0.5], uncertainty: 0.25, apriories: [0.5, 0.5]}");
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <unistd.h>
+
+#include "../src/cli/Pipeline.h"
+
+namespace {
+    // Around 50 bytes per line, so that the input spans several batches.
+    constexpr std::size_t line_count{150'000};
+
+    class TemporaryDirectory final {
+    public:
+        TemporaryDirectory() : path{std::filesystem::temp_directory_path()
+                                    / ("pipelineTest-" + std::to_string(::getpid()))} {
+            std::filesystem::create_directories(path);
+        }
+
+        TemporaryDirectory(const TemporaryDirectory &) = delete;
+        TemporaryDirectory &operator=(const TemporaryDirectory &) = delete;
+
+        ~TemporaryDirectory() {
+            std::filesystem::remove_all(path);
+        }
+
+        [[nodiscard]] std::string file(std::string_view name) const {
+            return (path / name).string();
+        }
+
+    private:
+        std::filesystem::path path;
+    };
+
+    // Every line has a distinct belief, so that reordered batches show in the output.
+    std::string make_input(std::size_t invalidLine = 0) {
+        std::ostringstream text{};
+        text << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (std::size_t line = 1; line <= line_count; ++line) {
+            if (line == invalidLine) {
+                text << "0.5 0.9 0.9 0.5 0.5\n";
+            } else {
+                double belief{static_cast<double>(line) / (2.0 * line_count)};
+                text << "0.5 " << belief << ' ' << 0.5 - belief << " 0.5 0.5\n";
+            }
+        }
+
+        return text.str();
+    }
+
+    void write_file(const std::string &path, std::string_view text) {
+        std::ofstream{path, std::ios::binary} << text;
+    }
+
+    std::string read_file(const std::string &path) {
+        std::ifstream in{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{in}, {}};
+    }
+
+    Arguments coarsen_arguments(const std::string &input, const std::string &output, std::size_t threads) {
+        Arguments arguments{};
+        arguments.input = input;
+        arguments.output = output;
+        arguments.threads = threads;
+        arguments.operation = Operation::Coarsen;
+        arguments.operand = 0;
+        return arguments;
+    }
+
+    std::string expected_output(const Arguments &arguments, std::string_view input) {
+        std::string out{};
+        std::ignore = process_text(arguments, input, 1, out);
+        return out;
+    }
+
+    BatchStats run(const Arguments &arguments) {
+        InputText input{arguments.input};
+        OutputWriter output{arguments.output};
+        return run_pipeline(arguments, input, output);
+    }
+}
+
+TEST(Pipeline, KeepsOrderAcrossWorkers) {
+    TemporaryDirectory directory{};
+    std::string inputPath{directory.file("input")};
+    std::string outputPath{directory.file("output")};
+    std::string input{make_input()};
+    ASSERT_GT(input.size(), 4 * pipeline_batch_bytes);
+    write_file(inputPath, input);
+
+    for (std::size_t threads : {2, 3}) {
+        auto arguments{coarsen_arguments(inputPath, outputPath, threads)};
+        BatchStats stats{run(arguments)};
+        EXPECT_EQ(stats.records, line_count);
+        EXPECT_EQ(stats.bytes, input.size());
+        EXPECT_EQ(read_file(outputPath), expected_output(arguments, input)) << threads << " threads";
+    }
+}
+
+TEST(Pipeline, ReadsStreamsInOrder) {
+    TemporaryDirectory directory{};
+    std::string outputPath{directory.file("output")};
+    std::string input{make_input()};
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    std::jthread feeder{[&input, fd = fds[1]] {
+        std::string_view rest{input};
+        while (!rest.empty()) {
+            ssize_t count{::write(fd, rest.data(), std::min<std::size_t>(rest.size(), 65536))};
+            if (count <= 0)
+                break;
+
+            rest.remove_prefix(static_cast<std::size_t>(count));
+        }
+
+        ::close(fd);
+    }};
+
+    std::string inputPath{"/proc/self/fd/" + std::to_string(fds[0])};
+    auto arguments{coarsen_arguments(inputPath, outputPath, 3)};
+    BatchStats stats{run(arguments)};
+    ::close(fds[0]);
+
+    EXPECT_EQ(stats.records, line_count);
+    EXPECT_EQ(read_file(outputPath), expected_output(arguments, input));
+}
+
+TEST(Pipeline, WritesBatchesBeforeAnInvalidRecord) {
+    TemporaryDirectory directory{};
+    std::string inputPath{directory.file("input")};
+    std::string outputPath{directory.file("output")};
+    constexpr std::size_t invalidLine{100'000};
+    std::string input{make_input(invalidLine)};
+    write_file(inputPath, input);
+
+    auto arguments{coarsen_arguments(inputPath, outputPath, 3)};
+    EXPECT_THROW(std::ignore = run(arguments), InvalidRecordError);
+
+    // Everything before the failing batch is written, nothing after it.
+    std::string output{read_file(outputPath)};
+    std::string expected{expected_output(arguments, make_input())};
+    auto lines{static_cast<std::size_t>(std::ranges::count(output, '\n'))};
+    std::size_t linesPerBatch{pipeline_batch_bytes / (input.size() / line_count) + 1};
+    EXPECT_TRUE(expected.starts_with(output));
+    EXPECT_LT(lines, invalidLine);
+    EXPECT_GT(lines + linesPerBatch, invalidLine);
+}
+
+TEST(Pipeline, ReportsReaderErrors) {
+    TemporaryDirectory directory{};
+    std::string outputPath{directory.file("output")};
+
+    // Reading a directory fails with EISDIR.
+    std::string inputPath{directory.file("directory")};
+    std::filesystem::create_directory(inputPath);
+    EXPECT_THROW(std::ignore = run(coarsen_arguments(inputPath, outputPath, 2)), InputError);
+    EXPECT_EQ(read_file(outputPath), "");
+}
+
+TEST(Pipeline, StopsAllStagesIfTheWriterFails) {
+    TemporaryDirectory directory{};
+    std::string inputPath{directory.file("input")};
+    write_file(inputPath, make_input() + make_input());
+
+    // Writes to /dev/full fail, while the reader and the workers are blocked on full queues.
+    EXPECT_THROW(std::ignore = run(coarsen_arguments(inputPath, "/dev/full", 2)), OutputError);
+}
@@ -0,0 +1,124 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/Sampling.h"
+
+TEST(Philox, KnownAnswers) {
+    // Known answer tests of the Random123 reference implementation.
+    EXPECT_EQ(philox4x32({0, 0, 0, 0}, {0, 0}),
+              (PhiloxCounter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (PhiloxCounter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+}
+
+TEST(BranchlessFunctions, MatchTheStandardLibrary) {
+    // A few ulp, relative to the result.
+    constexpr double tolerance{8 * std::numeric_limits<double>::epsilon()};
+    for (std::uint32_t bits = 0; bits < 0xfff00000; bits += 0x00100003) {
+        double u{uniform_open(bits)};
+        EXPECT_EQ(u, (static_cast<double>(bits) + 0.5) * 0x1p-32);
+        EXPECT_NEAR(branchless_log(u), std::log(u), tolerance * std::abs(std::log(u)));
+        EXPECT_NEAR(branchless_cos_two_pi(u), std::cos(2.0 * std::numbers::pi * u), tolerance);
+
+        double x{-700.0 * u};
+        EXPECT_NEAR(branchless_exp(x), std::exp(x), tolerance * std::exp(x));
+        EXPECT_NEAR(branchless_sqrt(1e10 * u), std::sqrt(1e10 * u), tolerance * std::sqrt(1e10 * u));
+    }
+
+    EXPECT_NEAR(branchless_log(1e300), std::log(1e300), tolerance * std::log(1e300));
+    EXPECT_EQ(branchless_exp(-800.0), 0.0);
+    EXPECT_EQ(branchless_sqrt(0.0), 0.0);
+    static_assert(branchless_exp(0.0) == 1.0);
+}
+
+TEST(SampleDirichlet, RowsAreDistributionsWithTheProjectedMean) {
+    std::array beliefs {0.1, 0.2, 0.3};
+    std::array apriories {0.2, 0.3, 0.5};
+    MultinomialOpinion<double, 3> opinion{std::span(beliefs), 0.4, std::span(apriories)};
+
+    constexpr std::size_t samples{100000};
+    std::vector<double> out(3 * samples);
+    sample_dirichlet(opinion, std::span(out), {.seed = 42, .threads = 2});
+
+    std::array<double, 3> mean{};
+    for (std::size_t i = 0; i < samples; ++i) {
+        double sum{0.0};
+        for (std::size_t k = 0; k < 3; ++k) {
+            double p{out[3 * i + k]};
+            ASSERT_GE(p, 0.0);
+            sum += p;
+            mean[k] += p / samples;
+        }
+
+        ASSERT_NEAR(sum, 1.0, 1e-12);
+    }
+
+    for (std::size_t k = 0; k < 3; ++k)
+        EXPECT_NEAR(mean[k], beliefs[k] + apriories[k] * 0.4, 0.005);
+}
+
+TEST(SampleDirichlet, ResultsDoNotDependOnThreadCount) {
+    std::array beliefs {0.0f, 0.5f, 0.0f, 0.25f};
+    std::array apriories {0.25f, 0.25f, 0.25f, 0.25f};
+    MultinomialOpinion<float, std::dynamic_extent> opinion{std::span(beliefs), 0.25f, std::span(apriories)};
+
+    std::vector<float> single(4 * 1000);
+    std::vector<float> multi(single.size());
+    sample_dirichlet(opinion, std::span(single), {.seed = 7, .threads = 1});
+    sample_dirichlet(opinion, std::span(multi), {.seed = 7, .threads = 5});
+    EXPECT_EQ(single, multi);
+
+    sample_dirichlet(opinion, std::span(multi), {.seed = 8, .threads = 5});
+    EXPECT_NE(single, multi);
+}
+
+TEST(SampleDirichlet, DogmaticOpinionAndInvalidOutput) {
+    std::array beliefs {0.25, 0.75};
+    std::array apriories {0.5, 0.5};
+    MultinomialOpinion<double, 2> opinion{std::span(beliefs), 0.0, std::span(apriories)};
+
+    std::vector<double> out(4);
+    sample_dirichlet(opinion, std::span(out));
+    EXPECT_THAT(out, testing::ElementsAre(0.25, 0.75, 0.25, 0.75));
+
+    std::vector<double> odd(3);
+    EXPECT_THROW(sample_dirichlet(opinion, std::span(odd)), std::invalid_argument);
+}
+
+TEST(SampleDirichlet, RethrowsExceptionsOfWorkerThreads) {
+    std::array alphas {1.0, 2.0};
+    auto failing {
+        [](std::size_t sample, std::size_t, double) {
+            if (sample == 700)
+                throw std::runtime_error("emit failed");
+        }
+    };
+
+    EXPECT_THROW(sample_dirichlet(std::span<const double>{alphas}, 1000, {.seed = 3, .threads = 4}, failing),
+                 std::runtime_error);
+}
+
+TEST(SampleBeta, MeanIsTheProjectedProbability) {
+    // Small parameters exercise the boost for shapes below one.
+    BinomialOpinion<double> opinion{0.05, 0.05, 0.9, 0.3};
+    std::vector<double> out(200000);
+    sample_beta(opinion, std::span(out), {.seed = 1, .threads = 3});
+
+    double mean{0.0};
+    for (double p : out) {
+        ASSERT_GE(p, 0.0);
+        ASSERT_LE(p, 1.0);
+        mean += p / static_cast<double>(out.size());
+    }
+
+    EXPECT_NEAR(mean, 0.05 + 0.3 * 0.9, 0.005);
+}
@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+
+#include <gmock/gmock.h>
+
+#include "../src/instrumentation/ScopeCounters.h"
+
+namespace {
+    constexpr int counted_square(int x) {
+        const ScopeCounters<"counted_square"> counters{};
+        return x * x;
+    }
+}
+
+TEST(ScopeCounters, UsableDuringConstantEvaluation) {
+    static_assert(counted_square(3) == 9);
+}
+
+TEST(ScopeCounters, CountsCallsAndTime) {
+    ScopeStats &stats{scope_stats<"counted_square">()};
+    auto calls{stats.calls.load()};
+
+    volatile int x{4};
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(counted_square(x), 16);
+
+    EXPECT_EQ(stats.calls.load(), calls + 10);
+    EXPECT_EQ(stats.name, "counted_square");
+
+    // Cycles come either from the hardware counters or the time stamp counter.
+    auto cycles{static_cast<std::size_t>(Counter::Cycles)};
+    EXPECT_EQ(stats.samples[cycles].load(), calls + 10);
+}
+
+TEST(ScopeCounters, ReportsAtExitOnlyIfEnabled) {
+    auto counted_exit {
+        [] {
+            {
+                const ScopeCounters<"counted_exit"> counters{};
+            }
+            std::exit(0);
+        }
+    };
+
+    if constexpr (instrumentation_enabled) {
+        EXPECT_EXIT(counted_exit(), testing::ExitedWithCode(0), testing::HasSubstr("counted_exit"));
+    } else {
+        EXPECT_EXIT(counted_exit(), testing::ExitedWithCode(0), testing::Not(testing::HasSubstr("counted_exit")));
+    }
+}
+
+TEST(ScopeCounters, ReportListsScopes) {
+    std::ignore = scope_stats<"reported">();
+    {
+        const ScopeCounters<"reported"> counters{};
+    }
+
+    char *text{nullptr};
+    std::size_t size{0};
+    std::FILE *out{open_memstream(&text, &size)};
+    ScopeRegistry::instance().report(out);
+    std::fclose(out);
+    EXPECT_THAT(text, testing::HasSubstr("reported"));
+    EXPECT_THAT(text, testing::HasSubstr("LLC misses"));
+    std::free(text);
+}
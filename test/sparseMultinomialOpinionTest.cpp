@@ -0,0 +1,110 @@
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/Operations.h"
+#include "../src/subjective_logic/SparseMultinomialOpinion.h"
+
+using Beliefs = std::vector<SparseBelief<double>>;
+
+TEST(CreateSparseMultinomialOpinion, StoresOnlyNonZeroBeliefs) {
+    SparseMultinomialOpinion<double> opinion{Beliefs{{3, 0.25}, {7, 0.0}, {40000, 0.5}}, 0.25,
+                                             BaseRates<double>::uniform(50000)};
+    EXPECT_EQ(opinion.size(), 50000);
+    EXPECT_EQ(opinion.nonZeroCount(), 2);
+    EXPECT_EQ(opinion.getBelief(3), 0.25);
+    EXPECT_EQ(opinion.getBelief(7), 0.0);
+    EXPECT_EQ(opinion.getBelief(40000), 0.5);
+    EXPECT_EQ(opinion.getApriori(12), 1.0 / 50000);
+}
+
+TEST(CreateSparseMultinomialOpinion, InvalidOpinionsThrow) {
+    auto baseRates{BaseRates<double>::uniform(4)};
+    EXPECT_THROW((SparseMultinomialOpinion<double>{Beliefs{{0, 0.5}}, 0.25, baseRates}), std::invalid_argument);
+    EXPECT_THROW((SparseMultinomialOpinion<double>{Beliefs{{4, 0.5}}, 0.5, baseRates}), std::invalid_argument);
+    EXPECT_THROW((SparseMultinomialOpinion<double>{Beliefs{{2, 0.25}, {1, 0.25}}, 0.5, baseRates}), std::invalid_argument);
+    EXPECT_THROW((SparseMultinomialOpinion<double>{Beliefs{{1, 0.25}, {1, 0.25}}, 0.5, baseRates}), std::invalid_argument);
+    EXPECT_THROW((SparseMultinomialOpinion<double>{Beliefs{{1, -0.5}}, 1.5, baseRates}), std::invalid_argument);
+}
+
+TEST(CreateBaseRates, InvalidBaseRatesThrow) {
+    EXPECT_THROW(std::ignore = BaseRates<double>::uniform(1), std::invalid_argument);
+    EXPECT_THROW(std::ignore = BaseRates<double>::shared(nullptr), std::invalid_argument);
+    EXPECT_THROW(std::ignore = BaseRates<double>::shared(std::make_shared<const std::vector<double>>(std::vector{0.5, 0.25})),
+                 std::invalid_argument);
+}
+
+TEST(SparseOperations, Coarsen) {
+    auto rates{std::make_shared<const std::vector<double>>(std::vector{0.5, 0.25, 0.125, 0.125})};
+    SparseMultinomialOpinion<double> opinion{Beliefs{{1, 0.25}, {3, 0.25}}, 0.5, BaseRates<double>::shared(rates)};
+
+    BinomialOpinion<double> coarsened{coarsen(opinion, 1)};
+    EXPECT_EQ(coarsened.getBelief(), 0.25);
+    EXPECT_EQ(coarsened.getDisbelief(), 0.25);
+    EXPECT_EQ(coarsened.getUncertainty(), 0.5);
+    EXPECT_EQ(coarsened.getApriori(), 0.25);
+
+    EXPECT_EQ(coarsen(opinion, 2).getBelief(), 0.0);
+    EXPECT_THROW(std::ignore = coarsen(opinion, 4), std::invalid_argument);
+}
+
+TEST(SparseOperations, DenseRoundTrip) {
+    std::vector beliefs {0.0, 0.5, 0.0, 0.25};
+    std::vector apriories {0.25, 0.25, 0.25, 0.25};
+    MultinomialOpinion<double, std::dynamic_extent> dense{std::span<const double>{beliefs}, 0.25,
+                                                          std::span<const double>{apriories}};
+
+    auto sparse{make_sparse(dense, BaseRates<double>::uniform(4))};
+    EXPECT_EQ(sparse.getBeliefs().size(), 2);
+    EXPECT_EQ(sparse.getBeliefs()[1], (SparseBelief<double>{3, 0.25}));
+    EXPECT_TRUE(sparse.getBaseRates().isUniform());
+
+    auto back{make_dense(sparse)};
+    EXPECT_THAT(back.getBeliefs(), testing::ElementsAreArray(beliefs));
+    EXPECT_THAT(back.getApriories(), testing::ElementsAreArray(apriories));
+    EXPECT_EQ(back.getUncertainty(), 0.25);
+
+    EXPECT_FALSE(make_sparse(dense).getBaseRates().isUniform());
+    EXPECT_THROW(std::ignore = make_sparse(dense, BaseRates<double>::uniform(5)), std::invalid_argument);
+}
+
+TEST(SparseOperations, DenseRoundTripOfLargeUniformDomain) {
+    for (std::size_t size : {10'000, 50'000}) {
+        SparseMultinomialOpinion<float> sparse{{{7, 0.25f}, {size - 1, 0.5f}}, 0.25f, BaseRates<float>::uniform(size)};
+        auto dense{make_dense(sparse)};
+        EXPECT_TRUE(dense.isValid());
+        EXPECT_EQ(dense.size(), size);
+        EXPECT_EQ(dense.getBeliefs()[size - 1], 0.5f);
+        EXPECT_EQ(dense.getApriories()[0], 1.0f / static_cast<float>(size));
+
+        auto back{make_sparse(dense, BaseRates<float>::uniform(size))};
+        EXPECT_THAT(back.getBeliefs(), testing::ElementsAreArray(sparse.getBeliefs()));
+        EXPECT_FALSE(make_sparse(dense).getBaseRates().isUniform());
+    }
+}
+
+TEST(SparseOperations, CumulativeFusion) {
+    auto baseRates{BaseRates<double>::uniform(100)};
+    SparseMultinomialOpinion<double> a{Beliefs{{1, 0.5}}, 0.5, baseRates};
+    SparseMultinomialOpinion<double> b{Beliefs{{1, 0.25}, {9, 0.25}}, 0.5, baseRates};
+
+    // Both weights are 0.5 / (0.5 + 0.5 - 0.25) = 2 / 3.
+    auto fused{cumulative_fuse(a, b)};
+    ASSERT_EQ(fused.nonZeroCount(), 2);
+    EXPECT_DOUBLE_EQ(fused.getBelief(1), 0.5);
+    EXPECT_DOUBLE_EQ(fused.getBelief(9), 1.0 / 6);
+    EXPECT_DOUBLE_EQ(fused.getUncertainty(), 1.0 / 3);
+
+    SparseMultinomialOpinion<double> dogmatic{Beliefs{{2, 1.0}}, 0.0, baseRates};
+    auto averaged{cumulative_fuse(dogmatic, SparseMultinomialOpinion<double>{Beliefs{{3, 1.0}}, 0.0, baseRates})};
+    EXPECT_EQ(averaged.getBelief(2), 0.5);
+    EXPECT_EQ(averaged.getBelief(3), 0.5);
+
+    EXPECT_THROW(std::ignore = cumulative_fuse(a, SparseMultinomialOpinion<double>{Beliefs{}, 1.0, BaseRates<double>::uniform(99)}),
+                 std::invalid_argument);
+}
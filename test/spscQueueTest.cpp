@@ -0,0 +1,67 @@
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/patterns/SpscQueue.h"
+
+TEST(SpscQueue, CapacityIsRoundedUpToPowerOfTwo) {
+    SpscQueue<int> queue{3};
+    EXPECT_EQ(queue.capacity(), 4);
+    EXPECT_THROW(SpscQueue<int>{0}, std::invalid_argument);
+}
+
+TEST(SpscQueue, TryPushFailsWhenFull) {
+    SpscQueue<int> queue{2};
+    int value{1};
+    EXPECT_TRUE(queue.tryPush(value));
+    value = 2;
+    EXPECT_TRUE(queue.tryPush(value));
+    value = 3;
+    EXPECT_FALSE(queue.tryPush(value));
+    EXPECT_EQ(value, 3);
+
+    EXPECT_EQ(queue.tryPop(), 1);
+    EXPECT_EQ(queue.tryPop(), 2);
+    EXPECT_EQ(queue.tryPop(), std::nullopt);
+}
+
+TEST(SpscQueue, PopReturnsNulloptOnceClosedAndDrained) {
+    SpscQueue<int> queue{4};
+    std::stop_source stop{};
+    EXPECT_TRUE(queue.push(1, stop.get_token()));
+    queue.close();
+    EXPECT_EQ(queue.pop(stop.get_token()), 1);
+    EXPECT_EQ(queue.pop(stop.get_token()), std::nullopt);
+}
+
+TEST(SpscQueue, PushGivesUpOnStop) {
+    SpscQueue<int> queue{1};
+    std::stop_source stop{};
+    EXPECT_TRUE(queue.push(1, stop.get_token()));
+    stop.request_stop();
+    EXPECT_FALSE(queue.push(2, stop.get_token()));
+}
+
+TEST(SpscQueue, TransfersAllValuesInOrder) {
+    constexpr std::size_t count{100000};
+    SpscQueue<std::size_t> queue{8};
+    std::stop_source stop{};
+    std::jthread producer{[&] {
+        for (std::size_t i = 0; i < count; ++i)
+            EXPECT_TRUE(queue.push(i, stop.get_token()));
+        queue.close();
+    }};
+
+    std::vector<std::size_t> received{};
+    while (auto value{queue.pop(stop.get_token())})
+        received.push_back(*value);
+
+    ASSERT_EQ(received.size(), count);
+    for (std::size_t i = 0; i < count; ++i)
+        EXPECT_EQ(received[i], i);
+}
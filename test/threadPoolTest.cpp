@@ -0,0 +1,64 @@
+#include <atomic>
+#include <cstddef>
+#include <latch>
+#include <stdexcept>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/patterns/ThreadPool.h"
+
+TEST(ThreadPool, ParallelForCoversEveryIndexOnce) {
+    ThreadPool pool{3};
+    std::vector<std::atomic<int>> visits(10'001);
+    pool.parallelFor(visits.size(), 64, [&visits](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            visits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    for (const auto &visit : visits)
+        EXPECT_EQ(visit.load(), 1);
+
+    pool.parallelFor(0, 64, [](std::size_t, std::size_t) { FAIL(); });
+}
+
+TEST(ThreadPool, RethrowsExceptionOfFirstFailingChunk) {
+    ThreadPool pool{2};
+    std::atomic<std::size_t> done{0};
+    auto run {
+        [&] {
+            pool.parallelFor(100, 10, [&done](std::size_t begin, std::size_t) {
+                done.fetch_add(1, std::memory_order_relaxed);
+                if (begin == 30)
+                    throw std::invalid_argument("30");
+                if (begin == 70)
+                    throw std::runtime_error("70");
+            });
+        }
+    };
+
+    EXPECT_THROW(run(), std::invalid_argument);
+    EXPECT_EQ(done.load(), 10);
+}
+
+TEST(ThreadPool, NestedParallelForDoesNotDeadlock) {
+    ThreadPool pool{2};
+    std::atomic<std::size_t> sum{0};
+    pool.parallelFor(8, 1, [&](std::size_t, std::size_t) {
+        pool.parallelFor(100, 7, [&sum](std::size_t begin, std::size_t end) {
+            sum.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+    });
+
+    EXPECT_EQ(sum.load(), 800);
+}
+
+TEST(ThreadPool, SubmittedTasksRun) {
+    ThreadPool pool{2};
+    std::latch finished{20};
+    for (int i = 0; i < 20; ++i)
+        pool.submit([&finished] { finished.count_down(); });
+
+    finished.wait();
+    SUCCEED();
+}
@@ -0,0 +1,72 @@
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../src/subjective_logic/BinomialOpinion.h"
+#include "../src/subjective_logic/MultinomialOpinion.h"
+#include "../src/subjective_logic/Validation.h"
+#include "../src/subjective_logic/BatchOperations.h"
+
+TEST(UncheckedConstruction, SkipsValidation) {
+    BinomialOpinion<double> invalid{unchecked, 0.5, 0.5, 0.5, 0.5};
+    EXPECT_FALSE(invalid.isValid());
+
+    BinomialOpinion<float> valid{unchecked, 0.25f, 0.25f, 0.5f, 0.5f};
+    EXPECT_TRUE(valid.isValid());
+    EXPECT_EQ(valid.getUncertainty(), 0.5f);
+
+    std::array beliefs {0.25, 0.25};
+    std::array apriories {0.5, 0.5};
+    MultinomialOpinion<double, 2> multinomial{unchecked, std::span(beliefs), 0.5, std::span(apriories)};
+    EXPECT_TRUE(multinomial.isValid());
+}
+
+TEST(UncheckedConstruction, CoarsenedOpinionsAreValid) {
+    // Valid, as a multinomial opinion of size 3 tolerates 4 epsilon, but not as a binomial one.
+    constexpr double epsilon{std::numeric_limits<double>::epsilon()};
+    std::array beliefs {0.5 + 2 * epsilon, 0.0, 0.0};
+    std::array apriories {0.25, 0.25, 0.5};
+    std::vector<MultinomialOpinion<double, 3>> opinions{};
+    opinions.emplace_back(std::span(beliefs), 0.5 + epsilon, std::span(apriories));
+
+    BinomialOpinion<double> coarsened{coarsen(opinions[0], 0)};
+    EXPECT_TRUE(coarsened.isValid());
+
+    std::vector<BinomialOpinion<double>> batch(1, BinomialOpinion<double>{0.0, 0.0, 1.0, 0.5});
+    ThreadPool pool{1};
+    coarsen_batch(std::span<const MultinomialOpinion<double, 3>>{opinions}, 0, std::span(batch), pool);
+    EXPECT_TRUE(all_valid(std::span<const BinomialOpinion<double>>{batch}));
+}
+
+TEST(FindInvalidOpinions, ReportsIndicesAcrossBlocks) {
+    std::vector<BinomialOpinion<float>> opinions(1000, BinomialOpinion<float>{0.25f, 0.25f, 0.5f, 0.5f});
+    opinions[3] = BinomialOpinion<float>{unchecked, 0.5f, 0.5f, 0.5f, 0.5f};
+    opinions[300] = BinomialOpinion<float>{unchecked, -0.5f, 1.0f, 0.5f, 0.5f};
+    opinions[999] = BinomialOpinion<float>{unchecked, 0.25f, 0.25f, 0.5f, 1.5f};
+
+    std::array<std::size_t, 8> invalid{};
+    std::size_t count{find_invalid_opinions(std::span<const BinomialOpinion<float>>{opinions}, std::span(invalid))};
+    ASSERT_EQ(count, 3);
+    EXPECT_THAT(std::span(invalid).first(count), testing::ElementsAre(3, 300, 999));
+
+    std::array<std::size_t, 1> single{};
+    EXPECT_EQ(find_invalid_opinions(std::span<const BinomialOpinion<float>>{opinions}, std::span(single)), 3);
+    EXPECT_EQ(single[0], 3);
+    EXPECT_FALSE(all_valid(std::span<const BinomialOpinion<float>>{opinions}));
+}
+
+TEST(FindInvalidOpinions, AllValid) {
+    std::array beliefs {0.1, 0.2, 0.3};
+    std::array apriories {0.2, 0.3, 0.5};
+    std::vector<MultinomialOpinion<double, 3>> opinions{};
+    for (int i = 0; i < 300; ++i)
+        opinions.emplace_back(std::span(beliefs), 0.4, std::span(apriories));
+
+    std::array<std::size_t, 1> invalid{};
+    EXPECT_EQ(find_invalid_opinions(std::span<const MultinomialOpinion<double, 3>>{opinions}, std::span(invalid)), 0);
+    EXPECT_TRUE(all_valid(std::span<const MultinomialOpinion<double, 3>>{opinions}));
+}